@@ -1,6 +1,5 @@
 #pragma once
 
-#include <unordered_map>
 #include <cstdint>
 #include <cstddef>
 #include <array>
@@ -116,36 +115,50 @@ namespace episteme {
         }
     };
 
-    static const std::unordered_map<char, std::pair<PieceType, Color>> piece_map = {
-        {'P', {PieceType::Pawn, Color::White}}, {'N', {PieceType::Knight, Color::White}}, 
-        {'B', {PieceType::Bishop, Color::White}}, {'R', {PieceType::Rook, Color::White}}, 
-        {'Q', {PieceType::Queen, Color::White}}, {'K', {PieceType::King, Color::White}}, 
-        {'p', {PieceType::Pawn, Color::Black}}, {'n', {PieceType::Knight, Color::Black}}, 
-        {'b', {PieceType::Bishop, Color::Black}}, {'r', {PieceType::Rook, Color::Black}}, 
-        {'q', {PieceType::Queen, Color::Black}}, {'k', {PieceType::King, Color::Black}}
-    };
+    constexpr std::array<char, 12> piece_chars = {'P', 'p', 'N', 'n', 'B', 'b', 'R', 'r', 'Q', 'q', 'K', 'k'};
+
+    constexpr std::array<Piece, 128> fill_char_pieces() {
+        std::array<Piece, 128> char_pieces{};
+        char_pieces.fill(Piece::None);
+
+        for (size_t i = 0; i < piece_chars.size(); i++) {
+            char_pieces[static_cast<size_t>(piece_chars[i])] = static_cast<Piece>(i);
+        }
+
+        return char_pieces;
+    }
+
+    constexpr std::array<Piece, 128> char_pieces = fill_char_pieces();
+
+    [[nodiscard]] constexpr Piece piece_from_char(char c) {
+        return (static_cast<unsigned char>(c) < char_pieces.size()) ? char_pieces[static_cast<unsigned char>(c)] : Piece::None;
+    }
+
+    [[nodiscard]] constexpr char piece_to_char(Piece piece) {
+        return piece_chars[static_cast<size_t>(piece)];
+    }
     
-    [[nodiscard]] inline PieceType piece_type(Piece piece) {
+    [[nodiscard]] constexpr PieceType piece_type(Piece piece) {
         return static_cast<PieceType>(static_cast<uint16_t>(piece) >> 1);
     };
 
-    [[nodiscard]] inline Color color(Piece piece) {
+    [[nodiscard]] constexpr Color color(Piece piece) {
         return static_cast<Color>(static_cast<uint16_t>(piece) & 0b1);
     };
 
-    [[nodiscard]] inline Color flip(Color color) {
+    [[nodiscard]] constexpr Color flip(Color color) {
         return static_cast<Color>(!static_cast<bool>(color));
     }
 
-    [[nodiscard]] inline Square flip(Square square) {
+    [[nodiscard]] constexpr Square flip(Square square) {
         return static_cast<Square>(static_cast<int16_t>(square) ^ 56);
     }
 
-    [[nodiscard]] inline Piece piece_type_with_color(PieceType piece_type, Color color) {
+    [[nodiscard]] constexpr Piece piece_type_with_color(PieceType piece_type, Color color) {
         return static_cast<Piece>(2 * static_cast<uint16_t>(piece_type) + static_cast<uint16_t>(color));
     }
 
-    [[nodiscard]] inline int16_t piecesquare(Piece piece, Square square, bool flip_color) {
+    [[nodiscard]] constexpr int16_t piecesquare(Piece piece, Square square, bool flip_color) {
         if (piece == Piece::None) {
             return -1;
         };
@@ -156,59 +169,59 @@ namespace episteme {
         return static_cast<int16_t>(stm) * 384 + static_cast<int16_t>(piece_type(piece)) * 64 + static_cast<int16_t>(location);
     }
 
-    [[nodiscard]] inline Piece pc_from_idx(uint16_t index) {
+    [[nodiscard]] constexpr Piece pc_from_idx(uint16_t index) {
         return static_cast<Piece>(index);
     }
 
-    [[nodiscard]] inline Square sq_from_idx(uint16_t index) {
+    [[nodiscard]] constexpr Square sq_from_idx(uint16_t index) {
         return static_cast<Square>(index);
     }
 
-    [[nodiscard]] inline uint16_t sq_idx(Square square) {
+    [[nodiscard]] constexpr uint16_t sq_idx(Square square) {
         return static_cast<uint16_t>(square);
     }
 
-    [[nodiscard]] inline uint16_t piece_idx(Piece piece) {
+    [[nodiscard]] constexpr uint16_t piece_idx(Piece piece) {
         return static_cast<uint16_t>(piece);
     }
 
-    [[nodiscard]] inline uint16_t piece_type_idx(PieceType piece_type) {
+    [[nodiscard]] constexpr uint16_t piece_type_idx(PieceType piece_type) {
         return static_cast<uint16_t>(piece_type);
     }
 
-    [[nodiscard]] inline uint16_t piece_type_idx(Piece piece) {
+    [[nodiscard]] constexpr uint16_t piece_type_idx(Piece piece) {
         return static_cast<uint16_t>(piece) >> 1;
     }
 
-    [[nodiscard]] inline uint16_t color_idx(Color color) {
+    [[nodiscard]] constexpr uint16_t color_idx(Color color) {
         return static_cast<uint16_t>(color);
     }
 
-    [[nodiscard]] inline uint16_t color_idx(Piece piece) {
+    [[nodiscard]] constexpr uint16_t color_idx(Piece piece) {
         return static_cast<uint16_t>(piece) & 0b1;
     }
 
-    [[nodiscard]] inline uint16_t file(Square square) {
+    [[nodiscard]] constexpr uint16_t file(Square square) {
         return sq_idx(square) % 8;
     }
 
-    [[nodiscard]] inline uint16_t rank(Square square) {
+    [[nodiscard]] constexpr uint16_t rank(Square square) {
         return sq_idx(square) / 8;
     }
 
-    [[nodiscard]] inline uint64_t shift_west(uint64_t bitboard) {
+    [[nodiscard]] constexpr uint64_t shift_west(uint64_t bitboard) {
         return (bitboard & ~FILE_A) >> 1; 
     }
 
-    [[nodiscard]] inline uint64_t shift_east(uint64_t bitboard) {
+    [[nodiscard]] constexpr uint64_t shift_east(uint64_t bitboard) {
         return (bitboard & ~FILE_H) << 1;
     }
 
-    [[nodiscard]] inline uint64_t shift_north(uint64_t bitboard) {
+    [[nodiscard]] constexpr uint64_t shift_north(uint64_t bitboard) {
         return (bitboard & ~RANK_8) << 8;
     }
 
-    [[nodiscard]] inline uint64_t shift_south(uint64_t bitboard) {
+    [[nodiscard]] constexpr uint64_t shift_south(uint64_t bitboard) {
         return (bitboard & ~RANK_1) >> 8;
     }
 }
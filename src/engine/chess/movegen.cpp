@@ -1,7 +1,7 @@
 #include "movegen.h"
 
 namespace episteme {
-    std::array<uint64_t, 64> fill_king_attacks() {
+    constexpr std::array<uint64_t, 64> fill_king_attacks() {
         std::array<uint64_t, 64> king_attacks;
         king_attacks.fill(0);
         for (int i = 0; i < 64; i++) {
@@ -15,7 +15,7 @@ namespace episteme {
         return king_attacks;
     }
 
-    std::array<uint64_t, 64> fill_knight_attacks() {
+    constexpr std::array<uint64_t, 64> fill_knight_attacks() {
         std::array<uint64_t, 64> knight_attacks;
         knight_attacks.fill(0);
         for (int i = 0; i < 64; i++) {
@@ -29,10 +29,10 @@ namespace episteme {
         return knight_attacks;
     }
 
-    const std::array<uint64_t, 64> KING_ATTACKS = fill_king_attacks();
-    const std::array<uint64_t, 64> KNIGHT_ATTACKS = fill_knight_attacks();
+    constexpr std::array<uint64_t, 64> KING_ATTACKS = fill_king_attacks();
+    constexpr std::array<uint64_t, 64> KNIGHT_ATTACKS = fill_knight_attacks();
 
-    std::array<uint64_t, 64> fill_rook_masks() {
+    constexpr std::array<uint64_t, 64> fill_rook_masks() {
         std::array<uint64_t, 64> rook_masks;
         rook_masks.fill(0);
         for (int i = 0; i < 64; i++) {
@@ -44,7 +44,7 @@ namespace episteme {
         return rook_masks;
     }
 
-    std::array<uint64_t, 64> fill_bishop_masks() {
+    constexpr std::array<uint64_t, 64> fill_bishop_masks() {
         std::array<uint64_t, 64> bishop_masks;
         bishop_masks.fill(0); 
         for (int i = 0; i < 64; i++) {
@@ -62,10 +62,10 @@ namespace episteme {
         return bishop_masks;
     }
 
-    const std::array<uint64_t, 64> ROOK_MASKS = fill_rook_masks();
-    const std::array<uint64_t, 64> BISHOP_MASKS = fill_bishop_masks();
+    constexpr std::array<uint64_t, 64> ROOK_MASKS = fill_rook_masks();
+    constexpr std::array<uint64_t, 64> BISHOP_MASKS = fill_bishop_masks();
 
-    uint64_t slow_rook_attacks(Square square, uint64_t blockers) {
+    constexpr uint64_t slow_rook_attacks(Square square, uint64_t blockers) {
         uint64_t rook_attacks = 0;
         size_t sq = sq_idx(square);
         uint64_t sq_bb = (uint64_t)1 << sq;
@@ -86,7 +86,7 @@ namespace episteme {
         return rook_attacks;
     }
     
-    uint64_t slow_bishop_attacks(Square square, uint64_t blockers) {
+    constexpr uint64_t slow_bishop_attacks(Square square, uint64_t blockers) {
         uint64_t bishop_attacks = 0;
         size_t sq = sq_idx(square);
         uint64_t sq_bb = (uint64_t)1 << sq;
@@ -137,6 +137,9 @@ namespace episteme {
         std::array<uint64_t, ARR_SIZE> used_indices;
         uint64_t mask = MASKS[sq_idx(square)];
 
+        const int bits = std::popcount(mask);
+        const size_t table_size = (size_t)1 << bits;
+
         uint64_t submask = 0;
         int num_moves = 0;
         do {
@@ -145,16 +148,18 @@ namespace episteme {
             num_moves++;
         } while (submask);
 
-        std::mt19937 gen(42);
+        // Seed per square so squares with similar masks don't all settle on the same first candidate
+        std::mt19937 gen(42 + sq_idx(square));
         std::uniform_int_distribution<uint64_t> dist(0, UINT64_MAX);
         bool fail;
         uint64_t magic;
         do {
-            used_indices.fill(0);
             magic = dist(gen) & dist(gen) & dist(gen);
-            fail = false;
+            fail = std::popcount((mask * magic) >> 56) < 6;
+
+            std::fill(used_indices.begin(), used_indices.begin() + table_size, 0);
             for (int i = 0; (!fail) && (i < num_moves); i++) {
-                const auto magic_idx = (submasks[i] * magic) >> (64 - NUM_BITS);
+                const auto magic_idx = (submasks[i] * magic) >> (64 - bits);
                 if (used_indices[magic_idx] == 0) {
                     used_indices[magic_idx] = attacks[i];
                 } else if (used_indices[magic_idx] != attacks[i]) {
@@ -163,9 +168,18 @@ namespace episteme {
             }
         } while (fail);
 
+        std::fill(used_indices.begin() + table_size, used_indices.end(), 0);
         return {magic, used_indices};
     }
 
+    std::pair<uint64_t, std::array<uint64_t, 4096>> find_rook_magics(Square square) {
+        return find_magics<12>(square, ROOK_MASKS, slow_rook_attacks);
+    }
+
+    std::pair<uint64_t, std::array<uint64_t, 512>> find_bishop_magics(Square square) {
+        return find_magics<9>(square, BISHOP_MASKS, slow_bishop_attacks);
+    }
+
     void print_magics() {
         std::cout << "const std::array<uint64_t, 64> ROOK_MAGICS = {";
         for (int i = 0; i < 64; i++) {
@@ -180,40 +194,97 @@ namespace episteme {
         std::cout << "}";
     }
 
-    template<size_t NUM_BITS, typename F>
-    std::array<std::array<uint64_t, (1 << NUM_BITS)>, 64> fill_attacks(const std::array<uint64_t, 64>& MAGICS, const std::array<uint64_t, 64>& MASKS, F slow_attacks) {
-        constexpr size_t ARR_SIZE = 1 << NUM_BITS;
-        std::array<std::array<uint64_t, ARR_SIZE>, 64> attack_tables{};
+    constexpr std::array<uint8_t, 64> fill_shifts(const std::array<uint64_t, 64>& MASKS) {
+        std::array<uint8_t, 64> shifts{};
+        for (int sq = 0; sq < 64; ++sq) {
+            shifts[sq] = 64 - std::popcount(MASKS[sq]);
+        }
+        return shifts;
+    }
+
+    constexpr std::array<uint32_t, 64> fill_offsets(const std::array<uint64_t, 64>& MASKS) {
+        std::array<uint32_t, 64> offsets{};
+        uint32_t offset = 0;
+        for (int sq = 0; sq < 64; ++sq) {
+            offsets[sq] = offset;
+            offset += (uint32_t)1 << std::popcount(MASKS[sq]);
+        }
+        return offsets;
+    }
+
+    constexpr std::array<uint8_t, 64> ROOK_SHIFTS = fill_shifts(ROOK_MASKS);
+    constexpr std::array<uint8_t, 64> BISHOP_SHIFTS = fill_shifts(BISHOP_MASKS);
+
+    constexpr std::array<uint32_t, 64> ROOK_OFFSETS = fill_offsets(ROOK_MASKS);
+    constexpr std::array<uint32_t, 64> BISHOP_OFFSETS = fill_offsets(BISHOP_MASKS);
+
+    // The table sizes are spelled out in the header, so check them against the layout the masks produce
+    static_assert(ROOK_OFFSETS[63] + (1ull << (64 - ROOK_SHIFTS[63])) == ROOK_TABLE_SIZE);
+    static_assert(BISHOP_OFFSETS[63] + (1ull << (64 - BISHOP_SHIFTS[63])) == BISHOP_TABLE_SIZE);
+
+    template<size_t TABLE_SIZE, typename F>
+    constexpr std::array<uint64_t, TABLE_SIZE> fill_attacks(const std::array<uint64_t, 64>& MAGICS, const std::array<uint64_t, 64>& MASKS, const std::array<uint8_t, 64>& SHIFTS, const std::array<uint32_t, 64>& OFFSETS, F slow_attacks) {
+        std::array<uint64_t, TABLE_SIZE> attack_table{};
     
         for (int sq = 0; sq < 64; ++sq) {
             const uint64_t mask = MASKS[sq];
-            std::array<uint64_t, ARR_SIZE> table{};
             uint64_t submask = 0;
             do {
-                const uint64_t index = (submask * MAGICS[sq]) >> (64 - NUM_BITS);
-                table[index] = slow_attacks(sq_from_idx(sq), submask);
+                const uint64_t index = (submask * MAGICS[sq]) >> SHIFTS[sq];
+                attack_table[OFFSETS[sq] + index] = slow_attacks(sq_from_idx(sq), submask);
                 submask = (submask - mask) & mask;
             } while (submask);
-            attack_tables[sq] = table;
         }
     
-        return attack_tables;
+        return attack_table;
     }
-    
-    std::array<std::array<uint64_t, 4096>, 64> fill_rook_attacks() {
-        return fill_attacks<12>(ROOK_MAGICS, ROOK_MASKS, slow_rook_attacks);
+
+    template<size_t TABLE_SIZE, typename F>
+    constexpr std::array<uint64_t, TABLE_SIZE> fill_pext_attacks(const std::array<uint64_t, 64>& MASKS, const std::array<uint32_t, 64>& OFFSETS, F slow_attacks) {
+        std::array<uint64_t, TABLE_SIZE> attack_table{};
+
+        // Carry-rippler enumeration visits submasks in pext order, so no BMI2 is needed to build the tables
+        for (int sq = 0; sq < 64; ++sq) {
+            const uint64_t mask = MASKS[sq];
+            uint64_t submask = 0;
+            uint32_t index = 0;
+            do {
+                attack_table[OFFSETS[sq] + index++] = slow_attacks(sq_from_idx(sq), submask);
+                submask = (submask - mask) & mask;
+            } while (submask);
+        }
+
+        return attack_table;
+    }
+
+    constexpr std::array<uint64_t, ROOK_TABLE_SIZE> ROOK_ATTACKS = fill_attacks<ROOK_TABLE_SIZE>(ROOK_MAGICS, ROOK_MASKS, ROOK_SHIFTS, ROOK_OFFSETS, slow_rook_attacks);
+    constexpr std::array<uint64_t, BISHOP_TABLE_SIZE> BISHOP_ATTACKS = fill_attacks<BISHOP_TABLE_SIZE>(BISHOP_MAGICS, BISHOP_MASKS, BISHOP_SHIFTS, BISHOP_OFFSETS, slow_bishop_attacks);
+
+    constexpr std::array<uint64_t, ROOK_TABLE_SIZE> ROOK_PEXT_ATTACKS = fill_pext_attacks<ROOK_TABLE_SIZE>(ROOK_MASKS, ROOK_OFFSETS, slow_rook_attacks);
+    constexpr std::array<uint64_t, BISHOP_TABLE_SIZE> BISHOP_PEXT_ATTACKS = fill_pext_attacks<BISHOP_TABLE_SIZE>(BISHOP_MASKS, BISHOP_OFFSETS, slow_bishop_attacks);
+
+    bool has_pext() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("bmi2");
     }
 
-    std::array<std::array<uint64_t, 512>, 64> fill_bishop_attacks() {
-        return fill_attacks<9>(BISHOP_MAGICS, BISHOP_MASKS, slow_bishop_attacks);
+    bool has_fast_pext() {
+        if (!has_pext()) return false;
+
+        // pext is microcoded on AMD before Zen 3
+        return !(__builtin_cpu_is("amdfam15h") || __builtin_cpu_is("amdfam17h"));
     }
 
-    const std::array<std::array<uint64_t, 4096>, 64> ROOK_ATTACKS = fill_rook_attacks();
-    const std::array<std::array<uint64_t, 512>, 64> BISHOP_ATTACKS = fill_bishop_attacks();
+    bool check_slider_backend() {
+        return SLIDER_BACKEND != SliderBackend::Pext || has_pext();
+    }
 
-    PawnAttacks get_pawn_attacks_helper(const Position& position, Color stm, bool is_pseudo) {
-        uint64_t us_bb = position.color_bb(stm);
-        uint64_t them_bb = position.color_bb(flip(stm));
+    template<Color STM>
+    PawnAttacks get_pawn_attacks_helper(const Position& position, bool is_pseudo) {
+        constexpr Color NTM = (STM == Color::White) ? Color::Black : Color::White;
+
+        uint64_t us_bb = position.color_bb(STM);
+        uint64_t them_bb = position.color_bb(NTM);
         uint64_t pawn_bb = position.piece_type_bb(PieceType::Pawn) & us_bb;
         
         uint64_t occupied = us_bb | (is_pseudo ? 0ULL : them_bb); 
@@ -221,7 +292,7 @@ namespace episteme {
     
         PawnAttacks attacks;
     
-        if (stm == Color::White) {
+        if constexpr (STM == Color::White) {
             attacks.push_1st = (pawn_bb << 8) & ~occupied;
             attacks.push_2nd = ((attacks.push_1st & RANK_3) << 8) & ~occupied;
             attacks.left_captures = ((pawn_bb & ~FILE_A) << 7) & captures_mask;
@@ -236,6 +307,9 @@ namespace episteme {
         return attacks;
     }
 
+    template PawnAttacks get_pawn_attacks_helper<Color::White>(const Position& position, bool is_pseudo);
+    template PawnAttacks get_pawn_attacks_helper<Color::Black>(const Position& position, bool is_pseudo);
+
     bool is_square_attacked(Square square, const Position& position, Color nstm) {
         uint64_t square_bb = uint64_t(1) << sq_idx(square);
         uint64_t them_bb = position.color_bb(nstm);
@@ -264,6 +338,43 @@ namespace episteme {
         return false;
     }
     
+    Threats get_threats(const Position& position) {
+        Threats threats;
+
+        for (Color color : {Color::White, Color::Black}) {
+            auto& attacks = threats.by_piece[color_idx(color)];
+
+            PawnAttacks pawn_attacks = get_pawn_pseudo_attacks(position, color);
+            attacks[piece_type_idx(PieceType::Pawn)] = pawn_attacks.left_captures | pawn_attacks.right_captures;
+
+            auto add_attacks = [&](PieceType piece_type, auto get_attacks) {
+                uint64_t piece_bb = position.piece_bb(piece_type, color);
+                uint64_t attacks_bb = 0;
+
+                while (piece_bb != 0) {
+                    attacks_bb |= get_attacks(sq_from_idx(std::countr_zero(piece_bb)));
+                    piece_bb &= piece_bb - 1;
+                }
+
+                attacks[piece_type_idx(piece_type)] = attacks_bb;
+            };
+
+            const uint64_t occupied = position.total_bb();
+
+            add_attacks(PieceType::Knight, get_knight_attacks);
+            add_attacks(PieceType::Bishop, [occupied](Square sq) { return get_bishop_attacks_direct(sq, occupied); });
+            add_attacks(PieceType::Rook, [occupied](Square sq) { return get_rook_attacks_direct(sq, occupied); });
+            add_attacks(PieceType::Queen, [occupied](Square sq) { return get_queen_attacks_direct(sq, occupied); });
+            add_attacks(PieceType::King, get_king_attacks);
+
+            for (uint64_t attacks_bb : attacks) {
+                threats.all[color_idx(color)] |= attacks_bb;
+            }
+        }
+
+        return threats;
+    }
+
     template<PieceType PT, typename F>
     void generate_piece_targets(MoveList& move_list, const Position& position, F get_attacks, bool include_quiets) {
         uint64_t us_bb = position.color_bb(position.STM());
@@ -294,24 +405,16 @@ namespace episteme {
         }
     }
 
+    template<Color STM>
     void generate_pawn_targets(MoveList& move_list, const Position& position, bool include_quiets) {
-        Color stm = position.STM();
-        PawnAttacks attacks = get_pawn_attacks(position, stm);
-        uint64_t promo_rank = (stm == Color::White) ? (RANK_8) : (RANK_1);
-        constexpr std::array<size_t, 2> left_capture_shift{ 7, 9 };
-        constexpr std::array<size_t, 2> right_capture_shift{ 9, 7 };
-        constexpr size_t push1st_shift = 8;
-        constexpr size_t push2nd_shift = 16;
-
-        auto get_from_sq = [stm](uint64_t attacks_bb, size_t shift) {
-            if (stm == Color::White) {
-                return sq_from_idx(std::countr_zero(attacks_bb) - shift);
-            } else {
-                return sq_from_idx(std::countr_zero(attacks_bb) + shift);
-            }
-        };
-
-        auto add_move = [promo_rank, &move_list](Square from_sq, Square to_sq) {
+        PawnAttacks attacks = get_pawn_attacks_helper<STM>(position, false);
+        constexpr uint64_t promo_rank = (STM == Color::White) ? (RANK_8) : (RANK_1);
+        constexpr int left_capture_shift = (STM == Color::White) ? 7 : -9;
+        constexpr int right_capture_shift = (STM == Color::White) ? 9 : -7;
+        constexpr int push1st_shift = (STM == Color::White) ? 8 : -8;
+        constexpr int push2nd_shift = (STM == Color::White) ? 16 : -16;
+
+        auto add_move = [&move_list](Square from_sq, Square to_sq) {
             if ((((uint64_t)1 << sq_idx(to_sq)) & promo_rank) != 0) {
                 for (auto promo_piece : {PromoPiece::Knight, PromoPiece::Bishop, PromoPiece::Rook, PromoPiece::Queen}) {
                     move_list.add({from_sq, to_sq, MoveType::Promotion, promo_piece});
@@ -321,11 +424,10 @@ namespace episteme {
             };
         };
 
-        auto attacks2Moves = [&](uint64_t attacks_bb, size_t shift) {
+        auto attacks2Moves = [&](uint64_t attacks_bb, int shift) {
             while (attacks_bb != 0) {
-                Square from_sq = get_from_sq(attacks_bb, shift);
-                Square to_sq = sq_from_idx(std::countr_zero(attacks_bb));
-                add_move(from_sq, to_sq);
+                int to_idx = std::countr_zero(attacks_bb);
+                add_move(sq_from_idx(to_idx - shift), sq_from_idx(to_idx));
                 attacks_bb &= attacks_bb - 1;
             }
         };
@@ -335,18 +437,18 @@ namespace episteme {
             attacks2Moves(attacks.push_2nd, push2nd_shift);
         }
 
-        attacks2Moves(attacks.left_captures, left_capture_shift[color_idx(stm)]);
-        attacks2Moves(attacks.right_captures, right_capture_shift[color_idx(stm)]);
+        attacks2Moves(attacks.left_captures, left_capture_shift);
+        attacks2Moves(attacks.right_captures, right_capture_shift);
     }
 
+    template<Color STM>
     void generate_en_passant(MoveList& move_list, const Position& position) {
         Square ep_sq = position.ep_square();
-        Color stm = position.STM();
         uint64_t ep_bb = (uint64_t)1 << sq_idx(ep_sq);
-        uint64_t pawn_bb = position.piece_bb(PieceType::Pawn, position.STM());
+        uint64_t pawn_bb = position.piece_bb(PieceType::Pawn, STM);
 
-        uint64_t left_attacks = (stm == Color::White) ? (((ep_bb & ~FILE_A) >> 9) & pawn_bb) : (((ep_bb & ~FILE_A) << 7) & pawn_bb);
-        uint64_t right_attacks = (stm == Color::White) ? (((ep_bb & ~FILE_H) >> 7) & pawn_bb) : (((ep_bb & ~FILE_H) << 9) & pawn_bb);
+        uint64_t left_attacks = (STM == Color::White) ? (((ep_bb & ~FILE_A) >> 9) & pawn_bb) : (((ep_bb & ~FILE_A) << 7) & pawn_bb);
+        uint64_t right_attacks = (STM == Color::White) ? (((ep_bb & ~FILE_H) >> 7) & pawn_bb) : (((ep_bb & ~FILE_H) << 9) & pawn_bb);
 
         if (left_attacks != 0) {
             Square from_sq = sq_from_idx(std::countr_zero(left_attacks));
@@ -358,20 +460,21 @@ namespace episteme {
         }
     }
 
+    template<Color STM>
     void generate_castles(MoveList& move_list, const Position& position, bool is_kingside) {
-        Color stm = position.STM();
-        uint64_t king_bb = position.piece_bb(PieceType::King, stm);
-        constexpr std::array<std::array<Square, 2>, 2> king_ends = {{
-            {Square::C1, Square::G1},
-            {Square::C8, Square::G8}
-        }};
+        constexpr Color NTM = (STM == Color::White) ? Color::Black : Color::White;
+        constexpr std::array<Square, 2> king_ends = (STM == Color::White)
+            ? std::array<Square, 2>{Square::C1, Square::G1}
+            : std::array<Square, 2>{Square::C8, Square::G8};
+
+        uint64_t king_bb = position.piece_bb(PieceType::King, STM);
 
         Square king_src = sq_from_idx(std::countr_zero(king_bb));
-        Square king_dst = king_ends[color_idx(stm)][is_kingside];
+        Square king_dst = king_ends[is_kingside];
 
-        Square rook_src = is_kingside ? position.castling_rights(stm).kingside : position.castling_rights(stm).queenside;
+        Square rook_src = is_kingside ? position.castling_rights(STM).kingside : position.castling_rights(STM).queenside;
 
-        if (is_square_attacked(king_src, position, position.NTM())) {
+        if (is_square_attacked(king_src, position, NTM)) {
             return;
         }
 
@@ -389,7 +492,7 @@ namespace episteme {
         }
 
         for (size_t sq = king_start; sq <= king_end; sq++) {
-            if ((sq != sq_idx(king_src)) && is_square_attacked(sq_from_idx(sq), position, position.NTM())) {
+            if ((sq != sq_idx(king_src)) && is_square_attacked(sq_from_idx(sq), position, NTM)) {
                 return;
             }
         }
@@ -397,8 +500,9 @@ namespace episteme {
         move_list.add({king_src, king_dst, MoveType::Castling});
     }
 
-    void generate_all_moves(MoveList& move_list, const Position& position) {
-        generate_pawn_moves(move_list, position);
+    template<Color STM>
+    void generate_moves(MoveList& move_list, const Position& position) {
+        generate_pawn_moves<STM>(move_list, position);
         generate_knight_moves(move_list, position);
         generate_bishop_moves(move_list, position);
         generate_rook_moves(move_list, position);
@@ -406,22 +510,23 @@ namespace episteme {
         generate_king_moves(move_list, position);
 
         if (position.ep_square() != Square::None) {
-            generate_en_passant(move_list, position);
+            generate_en_passant<STM>(move_list, position);
         }
 
-        Square kingside_castle = position.castling_rights(position.STM()).kingside;
-        Square queenside_castle = position.castling_rights(position.STM()).queenside;
+        Square kingside_castle = position.castling_rights(STM).kingside;
+        Square queenside_castle = position.castling_rights(STM).queenside;
 
         if (kingside_castle != Square::None) {
-            generate_castles(move_list, position, true);
+            generate_castles<STM>(move_list, position, true);
         }
         if (queenside_castle != Square::None) {
-            generate_castles(move_list, position, false);
+            generate_castles<STM>(move_list, position, false);
         }
     }
 
-    void generate_all_captures(MoveList& move_list, const Position& position) {
-        generate_pawn_captures(move_list, position);
+    template<Color STM>
+    void generate_captures(MoveList& move_list, const Position& position) {
+        generate_pawn_captures<STM>(move_list, position);
         generate_knight_captures(move_list, position);
         generate_bishop_captures(move_list, position);
         generate_rook_captures(move_list, position);
@@ -429,7 +534,110 @@ namespace episteme {
         generate_king_captures(move_list, position);
 
         if (position.ep_square() != Square::None) {
-            generate_en_passant(move_list, position);
+            generate_en_passant<STM>(move_list, position);
+        }
+    }
+
+    void generate_all_moves(MoveList& move_list, const Position& position) {
+        if (position.STM() == Color::White) generate_moves<Color::White>(move_list, position);
+        else generate_moves<Color::Black>(move_list, position);
+    }
+
+    void generate_all_captures(MoveList& move_list, const Position& position) {
+        if (position.STM() == Color::White) generate_captures<Color::White>(move_list, position);
+        else generate_captures<Color::Black>(move_list, position);
+    }
+
+    uint64_t get_attackers(Square square, uint64_t occupancy, const Position& position, Color by) {
+        uint64_t them_bb = position.color_bb(by);
+        uint64_t queens = position.piece_type_bb(PieceType::Queen);
+
+        uint64_t attackers = get_knight_attacks(square) & position.piece_type_bb(PieceType::Knight);
+        attackers |= get_king_attacks(square) & position.piece_type_bb(PieceType::King);
+        attackers |= get_pawn_sq_attacks(square, flip(by)) & position.piece_type_bb(PieceType::Pawn);
+        attackers |= get_bishop_attacks_direct(square, occupancy) & (position.piece_type_bb(PieceType::Bishop) | queens);
+        attackers |= get_rook_attacks_direct(square, occupancy) & (position.piece_type_bb(PieceType::Rook) | queens);
+
+        return attackers & them_bb & occupancy;
+    }
+
+    void generate_legal_moves(MoveList& move_list, const Position& position) {
+        Color stm = position.STM();
+        Color ntm = position.NTM();
+
+        MoveList pseudo_list;
+        generate_all_moves(pseudo_list, position);
+
+        uint64_t occupancy = position.total_bb();
+        uint64_t us_bb = position.color_bb(stm);
+        uint64_t them_bb = position.color_bb(ntm);
+        uint64_t king_bb = position.piece_bb(PieceType::King, stm);
+        Square king_sq = sq_from_idx(std::countr_zero(king_bb));
+
+        uint64_t queens = position.piece_type_bb(PieceType::Queen);
+        uint64_t rook_snipers = get_rook_attacks_direct(king_sq, them_bb) & (position.piece_type_bb(PieceType::Rook) | queens) & them_bb;
+        uint64_t bishop_snipers = get_bishop_attacks_direct(king_sq, them_bb) & (position.piece_type_bb(PieceType::Bishop) | queens) & them_bb;
+
+        uint64_t checkers = get_attackers(king_sq, occupancy, position, ntm);
+        uint64_t check_mask = ~uint64_t(0);
+        uint64_t pinned = 0;
+        std::array<uint64_t, 64> pin_rays;
+
+        auto add_sniper = [&](Square sniper_sq, uint64_t between) {
+            uint64_t sniper_bb = uint64_t(1) << sq_idx(sniper_sq);
+            uint64_t blockers = between & occupancy;
+
+            if (blockers == 0) check_mask = between | sniper_bb;
+            else if (std::has_single_bit(blockers) && (blockers & us_bb)) {
+                pinned |= blockers;
+                pin_rays[std::countr_zero(blockers)] = between | sniper_bb;
+            }
+        };
+
+        while (rook_snipers) {
+            Square sniper_sq = sq_from_idx(std::countr_zero(rook_snipers));
+            add_sniper(sniper_sq, get_rook_attacks_direct(king_sq, uint64_t(1) << sq_idx(sniper_sq)) & get_rook_attacks_direct(sniper_sq, king_bb));
+            rook_snipers &= rook_snipers - 1;
+        }
+        while (bishop_snipers) {
+            Square sniper_sq = sq_from_idx(std::countr_zero(bishop_snipers));
+            add_sniper(sniper_sq, get_bishop_attacks_direct(king_sq, uint64_t(1) << sq_idx(sniper_sq)) & get_bishop_attacks_direct(sniper_sq, king_bb));
+            bishop_snipers &= bishop_snipers - 1;
+        }
+
+        if (checkers == 0) check_mask = ~uint64_t(0);
+        else if (!std::has_single_bit(checkers)) check_mask = 0;
+        else if ((checkers & (position.piece_type_bb(PieceType::Bishop) | position.piece_type_bb(PieceType::Rook) | queens)) == 0) check_mask = checkers;
+
+        for (size_t i = 0; i < pseudo_list.count; i++) {
+            const Move& move = pseudo_list.list[i];
+            Square from_sq = move.from_square();
+            Square to_sq = move.to_square();
+            uint64_t from_bb = uint64_t(1) << sq_idx(from_sq);
+            uint64_t to_bb = uint64_t(1) << sq_idx(to_sq);
+
+            bool is_legal;
+            if (move.move_type() == MoveType::Castling) {
+                bool is_kingside = (sq_idx(to_sq) & 7) == 6;
+                Square rook_src = is_kingside ? position.castling_rights(stm).kingside : position.castling_rights(stm).queenside;
+                uint64_t rook_dst_bb = is_kingside ? (to_bb >> 1) : (to_bb << 1);
+
+                uint64_t castled_occupancy = (occupancy ^ from_bb ^ (uint64_t(1) << sq_idx(rook_src))) | to_bb | rook_dst_bb;
+                is_legal = get_attackers(to_sq, castled_occupancy, position, ntm) == 0;
+            }
+            else if (from_bb == king_bb) {
+                is_legal = get_attackers(to_sq, occupancy ^ king_bb, position, ntm) == 0;
+            }
+            else if (move.move_type() == MoveType::EnPassant) {
+                uint64_t captured_bb = (stm == Color::White) ? (to_bb >> 8) : (to_bb << 8);
+                uint64_t ep_occupancy = (occupancy ^ from_bb ^ captured_bb) | to_bb;
+                is_legal = get_attackers(king_sq, ep_occupancy, position, ntm) == 0;
+            }
+            else {
+                is_legal = (to_bb & check_mask) && (!(from_bb & pinned) || (to_bb & pin_rays[sq_idx(from_sq)]));
+            }
+
+            if (is_legal) move_list.add(move);
         }
     }
 }
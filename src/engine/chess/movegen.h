@@ -8,6 +8,7 @@
 #include <iostream>
 #include <algorithm>
 #include <random>
+#include <immintrin.h>
 
 namespace episteme {
     struct MoveList {
@@ -34,148 +35,140 @@ namespace episteme {
         uint64_t push_1st, push_2nd, left_captures, right_captures;
     };
 
-    const std::array<uint64_t, 64> ROOK_MAGICS = {
-        0x80024000802910,
-        0x100100821004040,
-        0x80a000a004840008,
-        0x2c08000420802008,
-        0x220004a108140200,
-        0x220004a108140200,
-        0x220004a108140200,
-        0x1000080644a0100,
-        0x491101020804000,
-        0x2000402914c0800,
-        0x8001201800402260,
-        0x100888002330004,
-        0x1012482010080080,
-        0xa80042100c010,
-        0x880804204004140,
-        0x8a0800080004229,
-        0x2040a0a001001140,
-        0x4000600a002000,
-        0x880602004450158,
-        0x4001248009000,
-        0x4001120011300a00,
-        0x100888002330004,
-        0x5020018004044122,
-        0x940801001020,
-        0x240010c8400400e0,
-        0x240001902028088,
-        0x101020005408,
-        0x1800022444002100,
-        0x101022002004810,
-        0x1820080050400,
-        0x90104012800a0003,
-        0x800804c0026480,
-        0x80802010002009a0,
-        0x120005644284000,
-        0x2040842000411,
-        0x2040842000411,
-        0x2040842000411,
-        0x2040842000411,
-        0x100888002330004,
-        0x2e508c480c020402,
-        0x8002004000860800,
-        0x2020134002042200,
-        0x5200109200208,
-        0x4001248009000,
-        0xc222200100202008,
-        0x41004004424a0802,
-        0x100888002330004,
-        0x120400050a80500,
-        0x24802290410100,
-        0x3a00802502504e0,
-        0x420010a11820c420,
-        0x880804204004140,
-        0x880804204004140,
-        0x204000282190220,
-        0x21200380410,
-        0x404020940082c020,
-        0x22100884288220a,
-        0x2801209200205642,
-        0x104420008208012,
-        0x42002824121042,
-        0x8001004010059,
-        0x1300800cc000101,
-        0x10010028105420c,
-        0x1000010020c28412,
+    constexpr std::array<uint64_t, 64> ROOK_MAGICS = {
+        0x2800091e0884004,
+        0x540042000100240,
+        0x81000a90a0014100,
+        0x3080048010000800,
+        0x1200081042008460,
+        0x100020801000400,
+        0x200008200010804,
+        0x4200040081034422,
+        0xa198800020400080,
+        0x1400020100040,
+        0x2000801000802005,
+        0x802804800100182,
+        0x1085000800110006,
+        0x100800200040080,
+        0x8161000402000100,
+        0x87000500108142,
+        0x580004040002000,
+        0x10014000600158,
+        0x90b0420020108204,
+        0x8910008010800800,
+        0x818008001c00,
+        0x1094004040020100,
+        0x1010100040200,
+        0x8008020000408401,
+        0x5140400080009020,
+        0x5a10005840002000,
+        0x201004100200010,
+        0x10090100100420,
+        0x2210080280040080,
+        0x10200801400410,
+        0xb18080400123110,
+        0x4600800180024100,
+        0x1104400488800020,
+        0x10012002c04000,
+        0x1400801000802000,
+        0x928200901001000,
+        0x1028000981800400,
+        0x102800200800400,
+        0x20104204004128,
+        0x2400004082000104,
+        0x852400224808000,
+        0x1100500020004000,
+        0x200900410010,
+        0x860100008008080,
+        0x1008800050010,
+        0x2000020004008080,
+        0x900015028440002,
+        0x20404081020004,
+        0x460208000400080,
+        0x6f40010020805900,
+        0x162282004200,
+        0x220040899200,
+        0x5180800d4008180,
+        0x202000280040080,
+        0x181000200040100,
+        0x2442009044010200,
+        0x208108220420502,
+        0x848110020820042,
+        0x4608308401202,
+        0x2000880490012101,
+        0x2000820041002,
+        0x300500084a8c0011,
+        0x1000008228100104,
+        0x400011408208142,
     };
 
-    const std::array<uint64_t, 64> BISHOP_MAGICS = {
-        0x3a00802502504e0,
-        0x81c0890900020a,
-        0x81c0890900020a,
-        0x880602004450158,
-        0x880804204004140,
-        0x880602004450158,
-        0x3a00802502504e0,
-        0xa80042100c010,
-        0x880602004450158,
-        0x3a00802502504e0,
-        0x880804204004140,
-        0x880602004450158,
-        0x81c0890900020a,
-        0x3a00802502504e0,
-        0x240001902028088,
-        0x880804204004140,
-        0x880804204004140,
-        0x880602004450158,
-        0x6062240086001204,
-        0x81c0890900020a,
-        0x220102200a48,
-        0x1a084010048048,
-        0x880804204004140,
-        0x880804204004140,
-        0x880602004450158,
-        0x880602004450158,
-        0x2020134002042200,
-        0x8080200820002,
-        0x101008800400a400,
-        0x2020134002042200,
-        0x880602004450158,
-        0x880602004450158,
-        0x4402010000a000,
-        0x880602004450158,
-        0x2000402914c0800,
-        0x902020080480080,
-        0x1002410041040140,
-        0x3a00802502504e0,
-        0x880602004450158,
-        0x880602004450158,
-        0x7710512080d0c,
-        0x7710512080d0c,
-        0x4020244008000090,
-        0x2000402914c0800,
-        0x21200380410,
-        0x3a00802502504e0,
-        0x81c0890900020a,
-        0x880602004450158,
-        0x3a00802502504e0,
-        0x1000c0100130001,
-        0x880602004450158,
-        0x880602004450158,
-        0x1360004002801402,
-        0x880804204004140,
-        0x3a00802502504e0,
-        0x81c0890900020a,
-        0x7710512080d0c,
-        0x880804204004140,
-        0x1360004002801402,
-        0x880602004450158,
-        0x140000010020010,
-        0x880804204004140,
-        0x880602004450158,
-        0x3a00802502504e0,
+    constexpr std::array<uint64_t, 64> BISHOP_MAGICS = {
+        0x40202a204040180,
+        0xa002080244004005,
+        0x408021042000000,
+        0x222082080a2c80,
+        0x2182021000040101,
+        0xa05101210520810,
+        0xc00104100c95c040,
+        0xc88402084104100,
+        0x40082008488720,
+        0x10a0100408009020,
+        0x811880a1020066,
+        0xa100940522002054,
+        0x6001020210208040,
+        0xa242460480000,
+        0x28a010410040400,
+        0x400820064020804,
+        0x40208908880084,
+        0x62003010422888,
+        0x10080880820108,
+        0x8080000820b4004,
+        0xe1000290400000,
+        0x1040201008200,
+        0x40001040a4300,
+        0xa450024040401,
+        0x10080005202440,
+        0x4214202020400,
+        0x888040028024110,
+        0xc2008008008002,
+        0xa100840218802001,
+        0x2808300a0806001,
+        0x9440a10800841000,
+        0x6621002132008450,
+        0x4412880400206001,
+        0x1055181800225040,
+        0x804032408080844,
+        0x24020081c80080,
+        0x2758010040100802,
+        0x2020408102248040,
+        0x2048080080104240,
+        0x1048004900044100,
+        0xc808080884040820,
+        0x40006c0404002000,
+        0x9004200404d0402,
+        0x8000004200800800,
+        0x208c880104010840,
+        0x8020008100420602,
+        0x2402104411200080,
+        0x180811014180b0,
+        0x1420a0612410010,
+        0x5020c602a4200801,
+        0x120c021081880ac,
+        0x400842020832,
+        0xc0002a082048004,
+        0x200401020900,
+        0x6104608801210080,
+        0xa2088114008004,
+        0x8000820082014035,
+        0x2010300610c2020,
+        0x8200144042400,
+        0x428848804840400,
+        0x12000008210102,
+        0x440804008010910,
+        0x404a8104c080051,
+        0x6048110902040100,
     };
 
-    [[nodiscard]] std::array<uint64_t, 64> fill_king_attacks();
-    [[nodiscard]] std::array<uint64_t, 64> fill_knight_attacks();
-    [[nodiscard]] std::array<uint64_t, 64> fill_bishop_masks();
-    [[nodiscard]] std::array<uint64_t, 64> fill_rook_masks();
-
-    [[nodiscard]] uint64_t slow_bishop_attacks(Square square, uint64_t blockers);
-    [[nodiscard]] uint64_t slow_rook_attacks(Square square, uint64_t blockers);
-
     [[nodiscard]] bool is_square_attacked(Square square, const Position& position, Color stm);
 
     [[nodiscard]] inline bool in_check(const Position& position, Color color) {
@@ -200,70 +193,111 @@ namespace episteme {
     template<size_t NUM_BITS, typename F>
     extern std::pair<uint64_t, std::array<uint64_t, 1 << NUM_BITS>> find_magics(Square square, std::array<uint64_t, 64> MASKS, F slow_attacks);
 
-    [[nodiscard]] inline std::pair<uint64_t, std::array<uint64_t, 4096>> find_rook_magics(Square square) {
-        return find_magics<12>(square, ROOK_MASKS, slow_rook_attacks);
-    }
+    [[nodiscard]] std::pair<uint64_t, std::array<uint64_t, 4096>> find_rook_magics(Square square);
+    [[nodiscard]] std::pair<uint64_t, std::array<uint64_t, 512>> find_bishop_magics(Square square);
+
+    void print_magics();
+
+    // Each square gets its own 1 << popcount(mask) slice (800 KB for rooks); getting near 100 KB would need overlapping magics
+    constexpr size_t ROOK_TABLE_SIZE = 102400;
+    constexpr size_t BISHOP_TABLE_SIZE = 5248;
+
+    extern const std::array<uint8_t, 64> ROOK_SHIFTS;
+    extern const std::array<uint8_t, 64> BISHOP_SHIFTS;
+
+    extern const std::array<uint32_t, 64> ROOK_OFFSETS;
+    extern const std::array<uint32_t, 64> BISHOP_OFFSETS;
+
+    extern const std::array<uint64_t, ROOK_TABLE_SIZE> ROOK_ATTACKS;
+    extern const std::array<uint64_t, BISHOP_TABLE_SIZE> BISHOP_ATTACKS;
+
+    extern const std::array<uint64_t, ROOK_TABLE_SIZE> ROOK_PEXT_ATTACKS;
+    extern const std::array<uint64_t, BISHOP_TABLE_SIZE> BISHOP_PEXT_ATTACKS;
+
+    enum class SliderBackend : uint8_t {
+        Magic, Pext
+    };
+
+    // Picked at build time so every lookup stays an inline table access; sliderbench still times both
+#ifdef EPISTEME_PEXT
+    constexpr SliderBackend SLIDER_BACKEND = SliderBackend::Pext;
+#else
+    constexpr SliderBackend SLIDER_BACKEND = SliderBackend::Magic;
+#endif
 
-    [[nodiscard]] inline std::pair<uint64_t, std::array<uint64_t, 512>> find_bishop_magics(Square square) {
-        return find_magics<9>(square, BISHOP_MASKS, slow_bishop_attacks);
+    constexpr const char* slider_backend_name(SliderBackend backend) {
+        return (backend == SliderBackend::Pext) ? "pext" : "magic";
     }
 
-    void print_magics();
+    [[nodiscard]] bool has_pext();
+    [[nodiscard]] bool has_fast_pext();
 
-    extern const std::array<std::array<uint64_t, 4096>, 64> ROOK_ATTACKS;
-    extern const std::array<std::array<uint64_t, 512>, 64> BISHOP_ATTACKS;
+    // False when this build's backend can't run on the cpu
+    [[nodiscard]] bool check_slider_backend();
 
-    template<size_t NUM_BITS>
-    [[nodiscard]] inline uint64_t get_slider_attacks(Square square, const Position& position, const std::array<uint64_t, 64>& MASKS, const std::array<uint64_t, 64>& MAGICS, const std::array<std::array<uint64_t, (1 << NUM_BITS)>, 64>& ATTACKS) {
+    template<size_t TABLE_SIZE>
+    [[nodiscard]] inline uint64_t get_slider_attacks_magic(Square square, uint64_t blockers, const std::array<uint64_t, 64>& MASKS, const std::array<uint64_t, 64>& MAGICS, const std::array<uint8_t, 64>& SHIFTS, const std::array<uint32_t, 64>& OFFSETS, const std::array<uint64_t, TABLE_SIZE>& ATTACKS) {
         size_t sq = sq_idx(square);
-        uint64_t blockers = position.total_bb();
         uint64_t rel_blockers = (blockers & MASKS[sq]);
         uint64_t data = rel_blockers * MAGICS[sq];
-        uint64_t idx = data >> (64 - NUM_BITS);
-        return ATTACKS[sq][idx];
+        uint64_t idx = data >> SHIFTS[sq];
+        return ATTACKS[OFFSETS[sq] + idx];
     }
 
-    [[nodiscard]] inline uint64_t get_rook_attacks(Square square, const Position& position) {
-        return get_slider_attacks<12>(square, position, ROOK_MASKS, ROOK_MAGICS, ROOK_ATTACKS);
+    [[nodiscard]] inline uint64_t get_rook_attacks_magic(Square square, uint64_t blockers) {
+        return get_slider_attacks_magic(square, blockers, ROOK_MASKS, ROOK_MAGICS, ROOK_SHIFTS, ROOK_OFFSETS, ROOK_ATTACKS);
     }
 
-    [[nodiscard]] inline uint64_t get_bishop_attacks(Square square, const Position& position) {
-        return get_slider_attacks<9>(square, position, BISHOP_MASKS, BISHOP_MAGICS, BISHOP_ATTACKS);
+    [[nodiscard]] inline uint64_t get_bishop_attacks_magic(Square square, uint64_t blockers) {
+        return get_slider_attacks_magic(square, blockers, BISHOP_MASKS, BISHOP_MAGICS, BISHOP_SHIFTS, BISHOP_OFFSETS, BISHOP_ATTACKS);
     }
 
-    [[nodiscard]] inline uint64_t get_queen_attacks(Square square, const Position& position) {
-        return (get_bishop_attacks(square, position) | get_rook_attacks(square, position));
+    // Only inlined into BMI2 code: the whole engine in a PEXT build, otherwise just sliderbench
+    [[nodiscard]] __attribute__((target("bmi2"))) inline uint64_t get_rook_attacks_pext(Square square, uint64_t blockers) {
+        size_t sq = sq_idx(square);
+        return ROOK_PEXT_ATTACKS[ROOK_OFFSETS[sq] + _pext_u64(blockers, ROOK_MASKS[sq])];
     }
 
-    template<size_t NUM_BITS>
-    inline uint64_t get_slider_attacks_direct(Square square, uint64_t blockers, const std::array<uint64_t, 64>& MASKS, const std::array<uint64_t, 64>& MAGICS, const std::array<std::array<uint64_t, (1 << NUM_BITS)>, 64>& ATTACKS) {
+    [[nodiscard]] __attribute__((target("bmi2"))) inline uint64_t get_bishop_attacks_pext(Square square, uint64_t blockers) {
         size_t sq = sq_idx(square);
-        uint64_t rel_blockers = (blockers & MASKS[sq]);
-        uint64_t data = rel_blockers * MAGICS[sq];
-        uint64_t idx = data >> (64 - NUM_BITS);
-        return ATTACKS[sq][idx];
+        return BISHOP_PEXT_ATTACKS[BISHOP_OFFSETS[sq] + _pext_u64(blockers, BISHOP_MASKS[sq])];
     }
 
     [[nodiscard]] inline uint64_t get_rook_attacks_direct(Square square, uint64_t blockers) {
-        return get_slider_attacks_direct<12>(square, blockers, ROOK_MASKS, ROOK_MAGICS, ROOK_ATTACKS);
+        if constexpr (SLIDER_BACKEND == SliderBackend::Pext) return get_rook_attacks_pext(square, blockers);
+        else return get_rook_attacks_magic(square, blockers);
     }
 
     [[nodiscard]] inline uint64_t get_bishop_attacks_direct(Square square, uint64_t blockers) {
-        return get_slider_attacks_direct<9>(square, blockers, BISHOP_MASKS, BISHOP_MAGICS, BISHOP_ATTACKS);
+        if constexpr (SLIDER_BACKEND == SliderBackend::Pext) return get_bishop_attacks_pext(square, blockers);
+        else return get_bishop_attacks_magic(square, blockers);
     }
 
     [[nodiscard]] inline uint64_t get_queen_attacks_direct(Square square, uint64_t blockers) {
         return (get_bishop_attacks_direct(square, blockers) | get_rook_attacks_direct(square, blockers));
     }
 
-    extern PawnAttacks get_pawn_attacks_helper(const Position& position, Color stm, bool is_pseudo);
+    [[nodiscard]] inline uint64_t get_rook_attacks(Square square, const Position& position) {
+        return get_rook_attacks_direct(square, position.total_bb());
+    }
+
+    [[nodiscard]] inline uint64_t get_bishop_attacks(Square square, const Position& position) {
+        return get_bishop_attacks_direct(square, position.total_bb());
+    }
+
+    [[nodiscard]] inline uint64_t get_queen_attacks(Square square, const Position& position) {
+        return (get_bishop_attacks(square, position) | get_rook_attacks(square, position));
+    }
+
+    template<Color STM>
+    extern PawnAttacks get_pawn_attacks_helper(const Position& position, bool is_pseudo);
 
     [[nodiscard]] inline PawnAttacks get_pawn_attacks(const Position& position, Color stm) {
-        return get_pawn_attacks_helper(position, stm, false);
+        return (stm == Color::White) ? get_pawn_attacks_helper<Color::White>(position, false) : get_pawn_attacks_helper<Color::Black>(position, false);
     }
     
     [[nodiscard]] inline PawnAttacks get_pawn_pseudo_attacks(const Position& position, Color stm) {
-        return get_pawn_attacks_helper(position, stm, true);
+        return (stm == Color::White) ? get_pawn_attacks_helper<Color::White>(position, true) : get_pawn_attacks_helper<Color::Black>(position, true);
     }    
 
     [[nodiscard]] inline uint64_t get_pawn_sq_attacks(Square square, Color stm) {
@@ -273,9 +307,30 @@ namespace episteme {
         else return ((sq_bb & ~FILE_A) >> 9) | ((sq_bb & ~FILE_H) >> 7);
     }
 
+    struct Threats {
+        std::array<std::array<uint64_t, 6>, 2> by_piece{};
+        std::array<uint64_t, 2> all{};
+
+        [[nodiscard]] inline uint64_t attacked_by(Color color) const {
+            return all[color_idx(color)];
+        }
+
+        [[nodiscard]] inline uint64_t attacked_by(PieceType piece_type, Color color) const {
+            return by_piece[color_idx(color)][piece_type_idx(piece_type)];
+        }
+
+        [[nodiscard]] inline uint64_t slider_attacks(Color color) const {
+            const auto& attacks = by_piece[color_idx(color)];
+            return attacks[piece_type_idx(PieceType::Bishop)] | attacks[piece_type_idx(PieceType::Rook)] | attacks[piece_type_idx(PieceType::Queen)];
+        }
+    };
+
+    [[nodiscard]] Threats get_threats(const Position& position);
+
     template<PieceType PT, typename F>
     extern void generate_piece_targets(MoveList& move_list, const Position& position, F get_attacks, bool include_quiets);
 
+    template<Color STM>
     extern void generate_pawn_targets(MoveList& move_list, const Position& position, bool include_quiets);
 
     inline void generate_knight_moves(MoveList& move_list, const Position& position) {
@@ -298,8 +353,9 @@ namespace episteme {
         generate_piece_targets<PieceType::King>(move_list, position, get_king_attacks, true);
     }
 
+    template<Color STM>
     inline void generate_pawn_moves(MoveList &move_list, const Position &position) {
-        generate_pawn_targets(move_list, position, true);
+        generate_pawn_targets<STM>(move_list, position, true);
     };
 
     inline void generate_knight_captures(MoveList& move_list, const Position& position) {
@@ -322,13 +378,26 @@ namespace episteme {
         generate_piece_targets<PieceType::King>(move_list, position, get_king_attacks, false);
     }
 
+    template<Color STM>
     inline void generate_pawn_captures(MoveList &move_list, const Position &position) {
-        generate_pawn_targets(move_list, position, false);
+        generate_pawn_targets<STM>(move_list, position, false);
     };
 
+    template<Color STM>
     void generate_en_passant(MoveList& move_list, const Position& position);
+
+    template<Color STM>
     void generate_castles(MoveList& move_list, const Position& position, bool is_kingside);
 
+    template<Color STM>
+    void generate_moves(MoveList& move_list, const Position& position);
+
+    template<Color STM>
+    void generate_captures(MoveList& move_list, const Position& position);
+
     void generate_all_moves(MoveList& move_list, const Position& position);
     void generate_all_captures(MoveList& move_list, const Position& position);
+
+    [[nodiscard]] uint64_t get_attackers(Square square, uint64_t occupancy, const Position& position, Color by);
+    void generate_legal_moves(MoveList& move_list, const Position& position);
 }
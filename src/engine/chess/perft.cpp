@@ -7,57 +7,192 @@ namespace episteme {
         return position;
     }
 
-    uint64_t perft(Position& position, int32_t depth) {
+    PerftTable::PerftTable(uint32_t size) : table((static_cast<size_t>(size) * 1024 * 1024) / sizeof(Entry)) {}
+
+    uint64_t perft(Position& position, int32_t depth, PerftTable* table) {
         if (depth == 0) {
             return 1;
         }
 
+        if (table && depth > 1) {
+            if (auto count = table->probe(position.zobrist(), depth)) return *count;
+        }
+
         MoveList move_list;
-        generate_all_moves(move_list, position);
+        generate_legal_moves(move_list, position);
+
+        if (depth == 1) {
+            return move_list.count;
+        }
+
         uint64_t move_count = 0;
 
         for (size_t i = 0; i < move_list.count; i++) {
             position.make_move(move_list.list[i]);
-        
-            uint64_t king_bb = position.piece_bb(PieceType::King, position.NTM());
-        
-            if (!is_square_attacked(sq_from_idx(std::countr_zero(king_bb)), position, position.STM())) {
-                move_count += perft(position, depth - 1);
-            }
-        
+            move_count += perft(position, depth - 1, table);
             position.unmake_move();
         }
+
+        if (table && depth > 1) table->store(position.zobrist(), depth, move_count);
         
         return move_count;
     }
 
-    void split_perft(Position& position, int32_t depth) {    
+    std::vector<uint64_t> divide_perft(const Position& position, const MoveList& move_list, int32_t depth, uint16_t num_threads, PerftTable* table) {
+        std::vector<uint64_t> counts(move_list.count);
+        std::atomic<size_t> next_move = 0;
+
+        auto worker = [&]() {
+            Position local = position;
+
+            size_t i;
+            while ((i = next_move.fetch_add(1, std::memory_order_relaxed)) < move_list.count) {
+                local.make_move(move_list.list[i]);
+                counts[i] = perft(local, depth - 1, table);
+                local.unmake_move();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (uint16_t i = 1; i < num_threads; i++) {
+            threads.emplace_back(worker);
+        }
+
+        worker();
+        for (auto& thread : threads) thread.join();
+
+        return counts;
+    }
+
+    void split_perft(Position& position, int32_t depth, uint16_t num_threads, uint32_t hash_size) {
+        using namespace std::chrono;
+
+        depth = std::max(depth, 1);
+        num_threads = std::max<uint16_t>(num_threads, 1);
+
         MoveList move_list;
-        generate_all_moves(move_list, position);
-    
+        generate_legal_moves(move_list, position);
+
+        std::optional<PerftTable> table;
+        if (hash_size) table.emplace(hash_size);
+
+        auto start = steady_clock::now();
+        std::vector<uint64_t> counts = divide_perft(position, move_list, depth, num_threads, table ? &*table : nullptr);
+        auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
         uint64_t total = 0;
-    
-        for (size_t i = 0; i < move_list.count; ++i) {
-            Move move = move_list.list[i];
-            position.make_move(move);
-
-            uint64_t king_bb = position.piece_bb(PieceType::King, position.NTM());
-
-            bool illegal = is_square_attacked(sq_from_idx(std::countr_zero(king_bb)), position, position.STM());
-    
-            uint64_t nodes = 0;
-            if (!illegal) {
-                nodes = perft(position, depth - 1);
-                total += nodes;
-                std::cout << move.to_string() << ": " << nodes << "\n";
-            }
-    
-            position.unmake_move();
+        for (size_t i = 0; i < move_list.count; i++) {
+            total += counts[i];
+            std::cout << move_list.list[i].to_string() << ": " << counts[i] << "\n";
         }
-    
+
+        uint64_t nps = (elapsed > 0) ? static_cast<uint64_t>(1e9 * total / elapsed) : total;
+
         std::cout << "Total nodes: " << total << "\n";
+        std::cout << "info depth " << depth << " threads " << num_threads << " hash " << hash_size << " nodes " << total << " time " << elapsed / 1000000 << " nps " << nps << std::endl;
+    }
+
+    bool perft_suite(const std::string& path, uint16_t num_threads) {
+        using namespace std::chrono;
+
+        std::ifstream file(path);
+        if (!file) {
+            std::cout << "could not open " << path << std::endl;
+            return false;
+        }
+
+        num_threads = std::max<uint16_t>(num_threads, 1);
+
+        std::string line;
+        uint64_t total_nodes = 0;
+        int64_t total_elapsed = 0;
+        size_t num_positions = 0;
+        size_t line_number = 0;
+        size_t num_malformed = 0;
+
+        while (std::getline(file, line)) {
+            line_number++;
+            size_t fields_end = line.find(';');
+            std::string FEN = line.substr(0, fields_end);
+            FEN.erase(FEN.find_last_not_of(" \t\r") + 1);
+            if (FEN.empty()) continue;
+
+            Position position;
+            if (FENError error = position.from_FEN(FEN); error != FENError::None) {
+                std::cout << "invalid fen: " << fen_error_string(error) << "\n" << FEN << std::endl;
+                return false;
+            }
+            num_positions++;
+
+            MoveList move_list;
+            generate_legal_moves(move_list, position);
+
+            // A malformed depth annotation fails the suite but doesn't stop it, so every bad line gets reported
+            const size_t malformed_before = num_malformed;
+            auto malformed = [&](const std::string& field) {
+                std::cout << "bad annotation at position " << num_positions << " line " << line_number << ": " << field << std::endl;
+                num_malformed++;
+            };
+
+            while (fields_end != std::string::npos) {
+                size_t next = line.find(';', fields_end + 1);
+                const std::string field = line.substr(fields_end + 1, next - fields_end - 1);
+                std::istringstream iss(field);
+                fields_end = next;
+
+                // Other EPD opcodes (id, bm, ...) are not ours to check
+                std::string token;
+                if (!(iss >> token) || token[0] != 'D') continue;
+
+                uint64_t expected;
+                int32_t depth = -1;
+                const char* last = token.data() + token.size();
+                auto [ptr, ec] = std::from_chars(token.data() + 1, last, depth);
+                if (ec != std::errc() || ptr != last || depth < 0 || !(iss >> expected) || !(iss >> std::ws).eof()) {
+                    malformed(field);
+                    continue;
+                }
+
+                // D0 is just the position itself, and divide_perft needs at least one ply
+                if (depth == 0) {
+                    if (expected != 1) {
+                        std::cout << "mismatch at position " << num_positions << " depth 0: expected " << expected << ", got 1\n";
+                        std::cout << "fen " << FEN << std::endl;
+                        return false;
+                    }
+                    total_nodes += 1;
+                    continue;
+                }
+
+                auto start = steady_clock::now();
+                std::vector<uint64_t> counts = divide_perft(position, move_list, depth, num_threads, nullptr);
+                total_elapsed += duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+                uint64_t nodes = 0;
+                for (uint64_t count : counts) nodes += count;
+                total_nodes += nodes;
+
+                if (nodes != expected) {
+                    std::cout << "mismatch at position " << num_positions << " depth " << depth << ": expected " << expected << ", got " << nodes << "\n";
+                    std::cout << "fen " << FEN << "\n";
+                    for (size_t i = 0; i < move_list.count; i++) {
+                        std::cout << move_list.list[i].to_string() << ": " << counts[i] << "\n";
+                    }
+                    std::cout << std::flush;
+                    return false;
+                }
+            }
+
+            if (num_malformed == malformed_before) std::cout << "info position " << num_positions << " ok" << std::endl;
+        }
+
+        uint64_t nps = (total_elapsed > 0) ? static_cast<uint64_t>(1e9 * total_nodes / total_elapsed) : total_nodes;
+
+        if (num_malformed) std::cout << "Suite failed: " << num_positions << " positions, " << num_malformed << " malformed annotations\n";
+        else std::cout << "Suite passed: " << num_positions << " positions\n";
+        std::cout << "info threads " << num_threads << " nodes " << total_nodes << " time " << total_elapsed / 1000000 << " nps " << nps << std::endl;
+        return num_malformed == 0;
     }
-    
 
     void time_perft(Position& position, int32_t depth) {
         using namespace std::chrono;
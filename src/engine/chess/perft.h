@@ -6,10 +6,53 @@
 #include <vector>
 #include <chrono>
 #include <iomanip>
+#include <thread>
+#include <atomic>
+#include <optional>
+#include <fstream>
+#include <sstream>
+#include <charconv>
 
 namespace episteme {
+    class PerftTable {
+        public:
+            PerftTable(uint32_t size);
+
+            [[nodiscard]] inline uint64_t table_index(uint64_t hash) const {
+                return static_cast<uint64_t>((static_cast<unsigned __int128>(hash) * static_cast<unsigned __int128>(table.size())) >> 64);
+            }
+
+            // Entries hold (count << 8 | depth) next to hash ^ data, so a torn or colliding entry fails the full-key check
+            [[nodiscard]] inline std::optional<uint64_t> probe(uint64_t hash, int32_t depth) const {
+                const Entry& entry = table[table_index(hash)];
+                uint64_t data = entry.data.load(std::memory_order_relaxed);
+                uint64_t check = entry.check.load(std::memory_order_relaxed);
+
+                if ((check ^ data) != hash || (data & 0xFF) != static_cast<uint64_t>(depth)) return std::nullopt;
+                return data >> 8;
+            }
+
+            inline void store(uint64_t hash, int32_t depth, uint64_t count) {
+                Entry& entry = table[table_index(hash)];
+                uint64_t data = (count << 8) | static_cast<uint64_t>(depth);
+
+                entry.data.store(data, std::memory_order_relaxed);
+                entry.check.store(hash ^ data, std::memory_order_relaxed);
+            }
+
+        private:
+            struct Entry {
+                std::atomic<uint64_t> check;
+                std::atomic<uint64_t> data;
+            };
+
+            std::vector<Entry> table;
+    };
+
     Position fen_to_position(const std::string& FEN);
-    uint64_t perft(Position &position, int32_t depth);
-    void split_perft(Position &position, int32_t depth);
+    uint64_t perft(Position &position, int32_t depth, PerftTable* table = nullptr);
+    std::vector<uint64_t> divide_perft(const Position& position, const MoveList& move_list, int32_t depth, uint16_t num_threads, PerftTable* table = nullptr);
+    void split_perft(Position &position, int32_t depth, uint16_t num_threads = 1, uint32_t hash_size = 0);
+    bool perft_suite(const std::string& path, uint16_t num_threads = 1);
     void time_perft(Position& position, int32_t depth);
 }
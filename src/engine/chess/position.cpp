@@ -5,72 +5,104 @@ namespace episteme {
         position_history.reserve(1024);
     }
 
-    void Position::from_FEN(const std::string& FEN) {
-        position_history.clear();
-        position_history.shrink_to_fit();
+    FENError Position::from_FEN(std::string_view FEN) {
+        constexpr std::string_view WHITESPACE = " \t\r\n";
 
-        std::array<std::string, 6> tokens;
-        size_t i = 0;
+        std::array<std::string_view, 6> fields{};
+        size_t num_fields = 0;
+        size_t field_start = 0;
 
-        std::istringstream iss(FEN);
-        std::string token;
-        while (iss >> token && i < tokens.size()) {
-            tokens[i++] = token;
+        while (num_fields < fields.size() && (field_start = FEN.find_first_not_of(WHITESPACE, field_start)) != std::string_view::npos) {
+            size_t field_end = FEN.find_first_of(WHITESPACE, field_start);
+            fields[num_fields++] = FEN.substr(field_start, field_end - field_start);
+            field_start = field_end;
         }
 
-        state.mailbox.fill(Piece::None);
-        state.bitboards.fill(0);
+        if (num_fields < 4) return FENError::MissingField;
+
+        PositionState parsed{};
+        int rank = 7;
+        int file = 0;
 
-        size_t square_idx = 56;
-        for (char c : tokens[0]) {
+        for (char c : fields[0]) {
             if (c == '/') {
-                square_idx -= 16;
-            } else if (std::isdigit(c)) {
-                square_idx += c - '0';
+                if (file != 8 || rank == 0) return FENError::Board;
+                rank--;
+                file = 0;
+            } else if (c >= '1' && c <= '8') {
+                file += c - '0';
+                if (file > 8) return FENError::Board;
             } else {
-                auto it = piece_map.find(c);
-                if (it != piece_map.end()) {
-                    PieceType type = it->second.first;
-                    Color color = it->second.second;
-                    Piece piece = piece_type_with_color(type, color);
-                    uint64_t sq = (uint64_t)1 << square_idx;
-
-                    state.bitboards[piece_type_idx(type)] ^= sq;
-                    state.bitboards[color_idx(color) + COLOR_OFFSET] ^= sq;
-                    state.mailbox[square_idx] = piece;
-                }
-                ++square_idx;
+                Piece piece = piece_from_char(c);
+                if (piece == Piece::None || file > 7) return FENError::Board;
+
+                size_t square_idx = rank * 8 + file;
+                uint64_t sq = (uint64_t)1 << square_idx;
+
+                parsed.bitboards[piece_type_idx(piece)] ^= sq;
+                parsed.bitboards[color_idx(piece) + COLOR_OFFSET] ^= sq;
+                parsed.mailbox[square_idx] = piece;
+                file++;
             }
         }
 
-        state.stm = (tokens[1] == "w") ? 0 : 1;
+        if (rank != 0 || file != 8) return FENError::Board;
+
+        for (Color color : {Color::White, Color::Black}) {
+            uint64_t king_bb = parsed.bitboards[piece_type_idx(PieceType::King)] & parsed.bitboards[color_idx(color) + COLOR_OFFSET];
+            if (std::popcount(king_bb) != 1) return FENError::Board;
+        }
+
+        if (fields[1] == "w") parsed.stm = color_idx(Color::White);
+        else if (fields[1] == "b") parsed.stm = color_idx(Color::Black);
+        else return FENError::SideToMove;
+
+        if (fields[2] != "-") {
+            for (char c : fields[2]) {
+                AllowedCastles::RookPair& white = parsed.allowed_castles.rooks[color_idx(Color::White)];
+                AllowedCastles::RookPair& black = parsed.allowed_castles.rooks[color_idx(Color::Black)];
 
-        if (tokens[2] != "-") {
-            for (char c : tokens[2]) {
                 switch (c) {
-                    case 'K': state.allowed_castles.rooks[color_idx(Color::White)].kingside = Square::H1; break;
-                    case 'Q': state.allowed_castles.rooks[color_idx(Color::White)].queenside = Square::A1; break;
-                    case 'k': state.allowed_castles.rooks[color_idx(Color::Black)].kingside = Square::H8; break;
-                    case 'q': state.allowed_castles.rooks[color_idx(Color::Black)].queenside = Square::A8; break;
+                    case 'K': if (white.is_kingside_set()) return FENError::Castling; white.kingside = Square::H1; break;
+                    case 'Q': if (white.is_queenside_set()) return FENError::Castling; white.queenside = Square::A1; break;
+                    case 'k': if (black.is_kingside_set()) return FENError::Castling; black.kingside = Square::H8; break;
+                    case 'q': if (black.is_queenside_set()) return FENError::Castling; black.queenside = Square::A8; break;
+                    default: return FENError::Castling;
                 }
             }
         }
 
-        if (tokens[3] != "-") {
-            state.ep_square = static_cast<Square>((tokens[3][0] - 'a') + (tokens[3][1] - '1') * 8);
+        if (fields[3] != "-") {
+            std::string_view ep = fields[3];
+            if (ep.size() != 2 || ep[0] < 'a' || ep[0] > 'h' || (ep[1] != '3' && ep[1] != '6')) return FENError::EnPassant;
+            parsed.ep_square = static_cast<Square>((ep[0] - 'a') + (ep[1] - '1') * 8);
         }
 
-        state.half_move_clock = std::stoi(tokens[4]);
-        state.full_move_number = std::stoi(tokens[5]);
+        // EPD records carry operations instead of clocks, so only numeric fields are read as clocks
+        parsed.half_move_clock = 0;
+        parsed.full_move_number = 1;
 
+        auto parse_clock = [](std::string_view field, auto& value) {
+            auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+            return ec == std::errc() && ptr == field.data() + field.size();
+        };
+
+        if (num_fields > 4 && std::isdigit(static_cast<unsigned char>(fields[4][0]))) {
+            if (!parse_clock(fields[4], parsed.half_move_clock)) return FENError::Clock;
+            if (num_fields > 5 && !parse_clock(fields[5], parsed.full_move_number)) return FENError::Clock;
+        }
+
+        state = parsed;
         state.hash = explicit_zobrist();
 
+        position_history.clear();
         position_history.push_back(state);
+
+        return FENError::None;
     }
 
     void Position::from_startpos() {
         position_history.clear();
-        position_history.shrink_to_fit();
 
         state.bitboards[piece_type_idx(PieceType::Pawn)]   = 0x00FF00000000FF00;
         state.bitboards[piece_type_idx(PieceType::Knight)] = 0x4200000000000042;
@@ -113,12 +145,22 @@ namespace episteme {
         state.full_move_number = 1;
         state.ep_square = Square::None;
 
-        state.hash = 0x33dc8684cf354d4a;
+        state.hash = explicit_zobrist();
 
         position_history.push_back(state);
     }
 
     void Position::make_move(const Move& move) {
+        if (STM() == Color::White) make_move<Color::White>(move);
+        else make_move<Color::Black>(move);
+    }
+
+    template<Color STM>
+    void Position::make_move(const Move& move) {
+        constexpr Color NTM = (STM == Color::White) ? Color::Black : Color::White;
+        constexpr int EP_OFFSET = (STM == Color::White) ? -8 : 8;
+        constexpr int DOUBLE_PUSH_DELTA = (STM == Color::White) ? static_cast<int>(DOUBLE_PUSH) : -static_cast<int>(DOUBLE_PUSH);
+
         Square sq_src = move.from_square();
         Square sq_dst = move.to_square();
 
@@ -128,9 +170,8 @@ namespace episteme {
         uint64_t bb_src = (uint64_t)1 << sq_idx(sq_src);
         uint64_t bb_dst = (uint64_t)1 << sq_idx(sq_dst);
 
-        Color side = STM();
-        auto us = color_idx(side);
-        auto them = color_idx(flip(side));
+        constexpr auto us = static_cast<uint16_t>(STM);
+        constexpr auto them = static_cast<uint16_t>(NTM);
 
         if (state.ep_square != Square::None) {
             state.hash ^= zobrist::ep_files[file(state.ep_square)];
@@ -143,7 +184,7 @@ namespace episteme {
             state.half_move_clock++;
         }
 
-        if (side == Color::Black) {
+        if constexpr (STM == Color::Black) {
             state.full_move_number++;
         }
 
@@ -185,10 +226,9 @@ namespace episteme {
                 }
 
                 if (piece_type(src) == PieceType::Pawn &&
-                    std::abs(sq_idx(sq_src) - sq_idx(sq_dst)) == DOUBLE_PUSH
+                    sq_idx(sq_dst) - sq_idx(sq_src) == DOUBLE_PUSH_DELTA
                 ) {
-                    int ep_offset = (side == Color::White) ? -8 : 8;
-                    state.ep_square = sq_from_idx(sq_idx(sq_dst) + ep_offset);
+                    state.ep_square = sq_from_idx(sq_idx(sq_dst) + EP_OFFSET);
                     state.hash ^= zobrist::ep_files[file(sq_dst)];
                 }
 
@@ -203,13 +243,13 @@ namespace episteme {
             case MoveType::Castling: {
                 bool king_side = bb_dst > bb_src;
                 Square rook_src = king_side ? state.allowed_castles.rooks[us].kingside : state.allowed_castles.rooks[us].queenside;
-                Square rook_dst = (side == Color::White)
-                    ? (king_side ? Square::F1 : Square::D1)
-                    : (king_side ? Square::F8 : Square::D8);
+                constexpr Square kingside_dst = (STM == Color::White) ? Square::F1 : Square::F8;
+                constexpr Square queenside_dst = (STM == Color::White) ? Square::D1 : Square::D8;
+                Square rook_dst = king_side ? kingside_dst : queenside_dst;
                 uint64_t bb_rook_src = (uint64_t)1 << sq_idx(rook_src);
                 uint64_t bb_rook_dst = (uint64_t)1 << sq_idx(rook_dst);
 
-                Piece rook_piece = piece_type_with_color(PieceType::Rook, side);
+                constexpr Piece rook_piece = (STM == Color::White) ? Piece::WhiteRook : Piece::BlackRook;
 
                 state.hash ^= zobrist::piecesquares[piecesquare(rook_piece, rook_src, false)];
                 state.hash ^= zobrist::piecesquares[piecesquare(rook_piece, rook_dst, false)];
@@ -219,7 +259,7 @@ namespace episteme {
                 state.bitboards[us + COLOR_OFFSET] ^= bb_rook_src ^ bb_rook_dst;
 
                 state.mailbox[sq_idx(rook_src)] = Piece::None;
-                state.mailbox[sq_idx(rook_dst)] = piece_type_with_color(PieceType::Rook, side);
+                state.mailbox[sq_idx(rook_dst)] = rook_piece;
 
                 dst = src;
 
@@ -234,11 +274,10 @@ namespace episteme {
             }
 
             case MoveType::EnPassant: {
-                int ep_offset = (side == Color::White) ? -8 : 8;
-                int capture_idx = sq_idx(sq_dst) + ep_offset;
+                int capture_idx = sq_idx(sq_dst) + EP_OFFSET;
                 uint64_t bb_cap = (uint64_t)1 << capture_idx;
 
-                Piece captured_pawn = piece_type_with_color(PieceType::Pawn, flip(side));
+                constexpr Piece captured_pawn = (STM == Color::White) ? Piece::BlackPawn : Piece::WhitePawn;
                 state.hash ^= zobrist::piecesquares[piecesquare(captured_pawn, sq_from_idx(capture_idx), false)];
                 state.hash ^= zobrist::piecesquares[piecesquare(src, sq_dst, false)];
 
@@ -271,7 +310,7 @@ namespace episteme {
                 }
 
                 PieceType promo_type = move.promo_piece_type();
-                Piece promo_piece = piece_type_with_color(promo_type, side);
+                Piece promo_piece = piece_type_with_color(promo_type, STM);
 
                 state.hash ^= zobrist::piecesquares[piecesquare(promo_piece, sq_dst, false)];
                 state.bitboards[piece_type_idx(promo_type)] ^= bb_dst;
@@ -340,55 +379,57 @@ namespace episteme {
         return true;
     }
 
-    std::string Position::to_FEN() const {
-        std::string fen;
-    
+    size_t Position::write_FEN(char* buffer) const {
+        char* out = buffer;
+
         for (int rank = 7; rank >= 0; --rank) {
             int empty = 0;
             for (int file = 0; file < 8; ++file) {
                 Piece piece = state.mailbox[rank * 8 + file];
                 if (piece == Piece::None) {
                     ++empty;
-                } else {
-                    if (empty != 0) {
-                        fen += std::to_string(empty);
-                        empty = 0;
-                    }
-                    char c;
-                    PieceType pt = piece_type(piece);
-                    Color col = color(piece);
-                    switch (pt) {
-                        case PieceType::Pawn:   c = 'p'; break;
-                        case PieceType::Knight: c = 'n'; break;
-                        case PieceType::Bishop: c = 'b'; break;
-                        case PieceType::Rook:   c = 'r'; break;
-                        case PieceType::Queen:  c = 'q'; break;
-                        case PieceType::King:   c = 'k'; break;
-                        default: c = '?';
-                    }
-                    fen += (col == Color::White) ? std::toupper(c) : c;
+                    continue;
+                }
+
+                if (empty != 0) {
+                    *out++ = static_cast<char>('0' + empty);
+                    empty = 0;
                 }
+                *out++ = piece_to_char(piece);
             }
-            if (empty != 0)
-                fen += std::to_string(empty);
-            if (rank != 0)
-                fen += '/';
+            if (empty != 0) *out++ = static_cast<char>('0' + empty);
+            if (rank != 0) *out++ = '/';
         }
-    
-        fen += (state.stm == static_cast<bool>(Color::White)) ? " w " : " b ";
-    
-        std::string castling;
-        if (state.allowed_castles.rooks[color_idx(Color::White)].is_kingside_set()) castling += 'K';
-        if (state.allowed_castles.rooks[color_idx(Color::White)].is_queenside_set()) castling += 'Q';
-        if (state.allowed_castles.rooks[color_idx(Color::Black)].is_kingside_set()) castling += 'k';
-        if (state.allowed_castles.rooks[color_idx(Color::Black)].is_queenside_set()) castling += 'q';
-        fen += (castling.empty() ? "-" : castling) + " ";
-    
-        fen += (state.ep_square == Square::None ? "-" : Move(state.ep_square, state.ep_square).to_string().substr(2)) + " ";
-    
-        fen += std::to_string(state.half_move_clock) + " " + std::to_string(state.full_move_number);
-    
-        return fen;
+
+        *out++ = ' ';
+        *out++ = (state.stm == static_cast<bool>(Color::White)) ? 'w' : 'b';
+        *out++ = ' ';
+
+        char* castling = out;
+        if (state.allowed_castles.rooks[color_idx(Color::White)].is_kingside_set()) *out++ = 'K';
+        if (state.allowed_castles.rooks[color_idx(Color::White)].is_queenside_set()) *out++ = 'Q';
+        if (state.allowed_castles.rooks[color_idx(Color::Black)].is_kingside_set()) *out++ = 'k';
+        if (state.allowed_castles.rooks[color_idx(Color::Black)].is_queenside_set()) *out++ = 'q';
+        if (out == castling) *out++ = '-';
+        *out++ = ' ';
+
+        if (state.ep_square == Square::None) *out++ = '-';
+        else {
+            *out++ = static_cast<char>('a' + file(state.ep_square));
+            *out++ = static_cast<char>('1' + rank(state.ep_square));
+        }
+        *out++ = ' ';
+
+        out = std::to_chars(out, buffer + MAX_FEN_SIZE, state.half_move_clock).ptr;
+        *out++ = ' ';
+        out = std::to_chars(out, buffer + MAX_FEN_SIZE, state.full_move_number).ptr;
+
+        return out - buffer;
+    }
+
+    std::string Position::to_FEN() const {
+        std::array<char, MAX_FEN_SIZE> buffer;
+        return std::string(buffer.data(), write_FEN(buffer.data()));
     }
 
     uint64_t Position::explicit_zobrist() {
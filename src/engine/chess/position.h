@@ -6,6 +6,8 @@
 #include <array>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <charconv>
 #include <ranges>
 #include <cstdint>
 #include <cstdlib>
@@ -37,6 +39,23 @@ namespace episteme {
         uint64_t hash = 0;
     };
 
+    enum class FENError : uint8_t {
+        None, MissingField, Board, SideToMove, Castling, EnPassant, Clock
+    };
+
+    [[nodiscard]] constexpr std::string_view fen_error_string(FENError error) {
+        switch (error) {
+            case FENError::None: return "none";
+            case FENError::MissingField: return "missing field";
+            case FENError::Board: return "malformed board";
+            case FENError::SideToMove: return "malformed side to move";
+            case FENError::Castling: return "malformed castling rights";
+            case FENError::EnPassant: return "malformed en passant square";
+            case FENError::Clock: return "malformed move clock";
+        }
+        return "unknown";
+    }
+
     class Position {
         public:
             Position();
@@ -109,7 +128,7 @@ namespace episteme {
                 return state.hash;
             }
 
-            void from_FEN(const std::string& FEN);
+            FENError from_FEN(std::string_view FEN);
             void from_startpos();
 
             void make_move(const Move& move);
@@ -119,12 +138,17 @@ namespace episteme {
             bool is_threefold();
             bool is_insufficient();
 
-            std::string to_FEN() const; 
+            size_t write_FEN(char* buffer) const;
+            std::string to_FEN() const;
             uint64_t explicit_zobrist();
         public:
             static const uint16_t COLOR_OFFSET = 6;
+            static constexpr size_t MAX_FEN_SIZE = 96;
 
         private:
+            template<Color STM>
+            void make_move(const Move& move);
+
             std::vector<PositionState> position_history;
             PositionState state;
     };
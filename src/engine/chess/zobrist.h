@@ -4,13 +4,73 @@
 
 #include <array>
 #include <cstdint>
-#include <random>
+#include <bit>
 
 namespace episteme::zobrist {
-    extern std::array<uint64_t, 768> piecesquares;
-    extern std::array<uint64_t, 16> castling_rights;
-    extern std::array<uint64_t, 8> ep_files;
-    extern uint64_t stm;
+    class PRNG {
+        public:
+            constexpr PRNG(uint64_t seed) : state(seed) {};
 
-    void init();
-}
\ No newline at end of file
+            [[nodiscard]] constexpr uint64_t next() {
+                uint64_t z = (state += 0x9E3779B97F4A7C15);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+                return z ^ (z >> 31);
+            }
+
+        private:
+            uint64_t state;
+    };
+
+    struct Keys {
+        std::array<uint64_t, 768> piecesquares{};
+        std::array<uint64_t, 16> castling_rights{};
+        std::array<uint64_t, 8> ep_files{};
+        uint64_t stm = 0;
+    };
+
+    [[nodiscard]] constexpr Keys generate_keys() {
+        PRNG prng(42);
+        Keys keys{};
+
+        for (int i = 0; i < 12; i++) {
+            for (int j = 0; j < 64; j++) {
+                keys.piecesquares[piecesquare(pc_from_idx(i), sq_from_idx(j), false)] = prng.next();
+            }
+        }
+
+        for (int i = 0; i < 8; i++) {
+            keys.ep_files[i] = prng.next();
+        }
+
+        keys.castling_rights[0] = 0;
+        keys.castling_rights[WHITE_KINGSIDE] = prng.next();
+        keys.castling_rights[WHITE_QUEENSIDE] = prng.next();
+        keys.castling_rights[BLACK_KINGSIDE] = prng.next();
+        keys.castling_rights[BLACK_QUEENSIDE] = prng.next();
+
+        for (uint8_t i = 0; i < 16; i++) {
+            if (std::popcount(i) < 2) continue;
+
+            uint64_t delta = 0;
+
+            if (i & WHITE_KINGSIDE) delta ^= keys.castling_rights[WHITE_KINGSIDE];
+            if (i & WHITE_QUEENSIDE) delta ^= keys.castling_rights[WHITE_QUEENSIDE];
+            if (i & BLACK_KINGSIDE) delta ^= keys.castling_rights[BLACK_KINGSIDE];
+            if (i & BLACK_QUEENSIDE) delta ^= keys.castling_rights[BLACK_QUEENSIDE];
+
+            keys.castling_rights[i] = delta;
+        }
+
+        keys.stm = prng.next();
+
+        return keys;
+    }
+
+    inline constexpr Keys keys = generate_keys();
+
+    inline constexpr const std::array<uint64_t, 768>& piecesquares = keys.piecesquares;
+    inline constexpr const std::array<uint64_t, 16>& castling_rights = keys.castling_rights;
+    inline constexpr const std::array<uint64_t, 8>& ep_files = keys.ep_files;
+    inline constexpr uint64_t stm = keys.stm;
+}
@@ -1,5 +1,7 @@
 #include "evaluate.h"
 
+#include <fstream>
+
 INCBIN(NNUE, EVALFILE);
 
 namespace episteme::eval {
@@ -22,6 +24,30 @@ namespace episteme::eval {
         return out;
     }
 
+    const NNUE* network() {
+        return nnue;
+    }
+
+    const NNUE* embedded_network() {
+        return reinterpret_cast<const NNUE*>(gNNUEData);
+    }
+
+    // Not synchronised with searches, only swap networks while no search is running
+    void set_network(const NNUE* network) {
+        nnue = network;
+    }
+
+    std::unique_ptr<NNUE> load_network(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return nullptr;
+
+        auto network = std::make_unique<NNUE>();
+        file.read(reinterpret_cast<char*>(network.get()), sizeof(NNUE));
+        if (file.gcount() != sizeof(NNUE)) return nullptr;
+
+        return network;
+    }
+
     bool SEE(const Position& position, const Move& move, int32_t threshold) {
         const Square from_sq = move.from_square();
         const Square to_sq = move.to_square();
@@ -108,4 +134,16 @@ namespace episteme::eval {
 
         return position.STM() == win;
     }
+
+    bool SEE(const Position& position, const Move& move, int32_t threshold, const Threats& threats) {
+        if (threshold <= 0) {
+            const uint64_t from_bb = (uint64_t)1 << move.from_idx();
+            const uint64_t to_bb = (uint64_t)1 << move.to_idx();
+
+            // Nothing of theirs reaches the target, and vacating the source cannot open one of their slider rays
+            if (!(threats.attacked_by(position.NTM()) & to_bb) && !(threats.slider_attacks(position.NTM()) & from_bb)) return true;
+        }
+
+        return SEE(position, move, threshold);
+    }
 }
\ No newline at end of file
@@ -5,9 +5,17 @@
 #include "../chess/movegen.h"
 #include "../../external/incbin.h"
 
+#include <memory>
+#include <string>
+
 namespace episteme::eval {
     nn::Accumulator update(const Position& position, const Move& move, nn::Accumulator accum);    
     nn::Accumulator reset(const Position& position);
     int32_t evaluate(nn::Accumulator& accumulator, Color stm);
+    const nn::NNUE* network();
+    const nn::NNUE* embedded_network();
+    void set_network(const nn::NNUE* network);
+    std::unique_ptr<nn::NNUE> load_network(const std::string& path);
     bool SEE(const Position& position, const Move& move, int32_t threshold);
+    bool SEE(const Position& position, const Move& move, int32_t threshold, const Threats& threats);
 }
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <x86intrin.h>
+
+#include <cstdint>
+#include <array>
+#include <iostream>
+#include <iomanip>
+
+namespace episteme::profile {
+#ifdef EPISTEME_PROFILE
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    enum class Category : uint8_t {
+        Search, Evaluate, Update, MoveGen, ScoreMove, MakeMove, UnmakeMove, TTProbe, SEE
+    };
+
+    constexpr size_t NUM_CATEGORIES = 9;
+    constexpr std::array<const char*, NUM_CATEGORIES> CATEGORY_NAMES = {
+        "search", "evaluate", "update", "movegen", "score_move", "make_move", "unmake_move", "tt_probe", "see"
+    };
+
+    // Cycles are self time: a timer nested inside another is subtracted from its parent
+    struct Timings {
+        std::array<uint64_t, NUM_CATEGORIES> cycles{};
+        std::array<uint64_t, NUM_CATEGORIES> calls{};
+        uint64_t nested = 0;
+
+        inline void clear() {
+            *this = Timings{};
+        }
+
+        inline Timings& operator+=(const Timings& other) {
+            for (size_t i = 0; i < NUM_CATEGORIES; i++) {
+                cycles[i] += other.cycles[i];
+                calls[i] += other.calls[i];
+            }
+            return *this;
+        }
+
+        void print() const {
+            uint64_t total = 0;
+            for (uint64_t c : cycles) total += c;
+
+            std::cout << std::fixed << std::setprecision(2);
+            for (size_t i = 0; i < NUM_CATEGORIES; i++) {
+                std::cout << "info string profile " << std::left << std::setw(12) << CATEGORY_NAMES[i] << std::right
+                    << std::setw(16) << cycles[i] << " cycles"
+                    << std::setw(8) << (total ? 100.0 * cycles[i] / total : 0.0) << "%"
+                    << std::setw(14) << calls[i] << " calls"
+                    << std::setw(16) << (calls[i] ? static_cast<double>(cycles[i]) / calls[i] : 0.0) << " cycles/call\n";
+            }
+            std::cout << "info string profile total " << total << " cycles" << std::endl;
+            std::cout << std::defaultfloat << std::setprecision(6);
+        }
+    };
+
+    inline thread_local Timings timings{};
+
+    class Scope {
+        public:
+            explicit inline Scope(Category category) : category(category) {
+                if constexpr (ENABLED) {
+                    outer_nested = timings.nested;
+                    timings.nested = 0;
+                    start = __rdtsc();
+                }
+            }
+
+            inline ~Scope() {
+                if constexpr (ENABLED) {
+                    const uint64_t elapsed = __rdtsc() - start;
+                    const size_t idx = static_cast<size_t>(category);
+
+                    timings.cycles[idx] += elapsed - timings.nested;
+                    timings.calls[idx]++;
+                    timings.nested = outer_nested + elapsed;
+                }
+            }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            Category category;
+            uint64_t start = 0;
+            uint64_t outer_nested = 0;
+    };
+
+    template<typename F>
+    inline decltype(auto) timed([[maybe_unused]] Category category, F&& fn) {
+        if constexpr (ENABLED) {
+            Scope scope(category);
+            return fn();
+        } else {
+            return fn();
+        }
+    }
+}
@@ -7,32 +7,60 @@ namespace episteme::search {
     using namespace std::chrono;
 
     void pick_move(ScoredList& scored_list, int start) {
-        for (size_t i = start + 1; i < scored_list.count; i++)    {
-            if (scored_list.list[i].score > scored_list.list[start].score) {
+        const int32_t* keys = scored_list.keys.data();
+        const size_t count = scored_list.count;
+
+        size_t i = start;
+        __m256i best_vec = _mm256_set1_epi32(INT32_MIN);
+        for (; i + 8 <= count; i += 8) {
+            best_vec = _mm256_max_epi32(best_vec, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)));
+        }
+
+        __m128i best_128 = _mm_max_epi32(_mm256_castsi256_si128(best_vec), _mm256_extracti128_si256(best_vec, 1));
+        best_128 = _mm_max_epi32(best_128, _mm_shuffle_epi32(best_128, _MM_SHUFFLE(1, 0, 3, 2)));
+        best_128 = _mm_max_epi32(best_128, _mm_shuffle_epi32(best_128, _MM_SHUFFLE(2, 3, 0, 1)));
+
+        int32_t best = _mm_cvtsi128_si32(best_128);
+        for (; i < count; i++) {
+            best = std::max(best, keys[i]);
+        }
+
+        // Each move appears once, so keys are unique and the first match is the maximum
+        const __m256i target = _mm256_set1_epi32(best);
+        for (i = start; i + 8 <= count; i += 8) {
+            __m256i matches = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), target);
+            uint32_t mask = _mm256_movemask_ps(_mm256_castsi256_ps(matches));
+            if (mask) {
+                scored_list.swap(start, i + std::countr_zero(mask));
+                return;
+            }
+        }
+
+        for (; i < count; i++) {
+            if (keys[i] == best) {
                 scored_list.swap(start, i);
+                return;
             }
         }
     }
 
     template<typename F>
-    ScoredList Worker::generate_scored_targets(const Position& position, F generator, const tt::Entry& tt_entry, std::optional<int32_t> ply) {
+    ScoredList Worker::generate_scored_targets(const Position& position, F generator, const tt::Entry& tt_entry, std::optional<int32_t> ply, const Threats* threats) {
         MoveList move_list;
-        generator(move_list, position);
+        profile::timed(profile::Category::MoveGen, [&] { generator(move_list, position); });
         ScoredList scored_list;
 
         for (size_t i = 0; i < move_list.count; i++) {
-            scored_list.add(score_move(position, move_list.list[i], tt_entry, ply));
+            profile::Scope scope(profile::Category::ScoreMove);
+            scored_list.add(move_list.list[i], score_move(position, move_list.list[i], tt_entry, ply, threats));
         }
 
         return scored_list;
     }
 
-    ScoredMove Worker::score_move(const Position& position, const Move& move, const tt::Entry& tt_entry, std::optional<int32_t> ply) {
-        ScoredMove scored_move{.move = move};
-
+    int16_t Worker::score_move(const Position& position, const Move& move, const tt::Entry& tt_entry, std::optional<int32_t> ply, const Threats* threats) {
         if (tt_entry.move.data() == move.data()) {
-            scored_move.score = 10000000;
-            return scored_move;
+            return TT_MOVE_SCORE;
         }
 
         Piece src = position.mailbox(move.from_square());
@@ -43,75 +71,116 @@ namespace episteme::search {
         if (is_capture) {
             int32_t src_val = piece_vals[piece_type_idx(src)];
             int32_t dst_val = move.move_type() == MoveType::EnPassant ? piece_vals[piece_type_idx(PieceType::Pawn)] : piece_vals[piece_type_idx(dst)];
+            int32_t mvv_lva = dst_val * 10 - src_val;
 
-            scored_move.score += dst_val * 10 - src_val;
-            if (eval::SEE(position, move, 0)) scored_move.score += 1000000;
+            // The SEE(0) outcome is kept in the score band, so later pruning can reuse it
+            bool see = profile::timed(profile::Category::SEE, [&] { return threats ? eval::SEE(position, move, 0, *threats) : eval::SEE(position, move, 0); });
+            return static_cast<int16_t>(see ? GOOD_CAPTURE_SCORE + mvv_lva : mvv_lva / 2);
         } else {
             if (stack[*ply].killer.data() == move.data()) {
-                scored_move.score = 800000;
-                return scored_move;
+                return KILLER_SCORE;
             }
 
-            scored_move.score += history.get_quiet_hist(position.STM(), move);
-            scored_move.score += history.get_cont_hist(stack, src, move, *ply);
+            int32_t hist = history.get_quiet_hist(position.STM(), move) + history.get_cont_hist(stack, src, move, *ply);
+            return static_cast<int16_t>(hist / 2);
+        }
+    }
+
+    constexpr double constexpr_log(double x) {
+        constexpr double LN_2 = 0.693147180559945309417232121458;
+
+        int exponent = 0;
+        while (x >= 2.0) x /= 2.0, exponent++;
+        while (x < 1.0) x *= 2.0, exponent--;
+
+        // ln(x) = 2 * atanh((x - 1) / (x + 1)), which converges quickly for x in [1, 2)
+        const double t = (x - 1.0) / (x + 1.0);
+        double term = t;
+        double sum = 0.0;
+        for (int k = 1; k < 64; k += 2) {
+            sum += term / k;
+            term *= t * t;
         }
 
-        return scored_move;
+        return 2.0 * sum + exponent * LN_2;
     }
 
-    std::array<std::array<int16_t, 64>, 64> lmr_table{};
-    void init_lmr_table() {
+    constexpr std::array<std::array<int16_t, 64>, 64> fill_lmr_table() {
+        std::array<std::array<int16_t, 64>, 64> table{};
         for (int i = 1; i < 64; i++) {
             for (int j = 1; j < 64; j++) {
-                lmr_table[i][j] = 0.5 + std::log(i) * std::log(j) / 3.0;
+                table[i][j] = 0.5 + constexpr_log(i) * constexpr_log(j) / 3.0;
             }
         }
+        return table;
     }
 
+    constexpr std::array<std::array<int16_t, 64>, 64> lmr_table = fill_lmr_table();
+
     template<bool PV_node>
     int32_t Worker::search(Position& position, Line& PV, int16_t depth, int16_t ply, int32_t alpha, int32_t beta, SearchLimits limits) {
+        const int32_t entry_alpha = alpha;
+        auto traced = [&](int32_t score, trace::Reason reason) {
+            if constexpr (trace::ENABLED) {
+                if (tracer.active()) tracer.write(trace::Kind::Search, reason, (ply > 0) ? stack[ply - 1].move : Move(), ply, depth, entry_alpha, beta, score);
+            }
+            return score;
+        };
+
         if (nodes % 2000 == 0 && limits.time_exceeded()) {
             should_stop = true;
-            return 0;
+            return traced(0, trace::Reason::Stopped);
         };
 
-        if (ply > 0 && position.is_threefold()) return 0;
+        if (ply > 0 && position.is_threefold()) return traced(0, trace::Reason::Draw);
 
         if (depth <= 0) {
             return quiesce(position, PV, ply, alpha, beta, limits);
         }
 
+        if constexpr (stats::ENABLED) stats::counters.search_nodes++;
+
         tt::Entry tt_entry{};
         if (!stack[ply].excluded.data()) {
-            tt_entry = ttable.probe(position.zobrist());
+            tt_entry = profile::timed(profile::Category::TTProbe, [&] { return ttable.probe(position.zobrist()); });
+
+            if constexpr (stats::ENABLED) {
+                stats::counters.tt_probes++;
+                stats::counters.tt_hits += tt_entry.node_type != tt::NodeType::None;
+            }
+
             if (ply > 0 && (tt_entry.depth >= depth
                 && ((tt_entry.node_type == tt::NodeType::PVNode)
                     || (tt_entry.node_type == tt::NodeType::AllNode && tt_entry.score <= alpha)
                     || (tt_entry.node_type == tt::NodeType::CutNode && tt_entry.score >= beta))
                 )
             ) {
-                return tt_entry.score;
+                if constexpr (stats::ENABLED) stats::counters.tt_cutoffs++;
+                return traced(tt_entry.score, trace::Reason::TTCutoff);
             }    
         }
 
         constexpr bool is_PV = PV_node;
 
+        const Threats threats = get_threats(position);
+        const bool is_check = threats.attacked_by(position.NTM()) & position.piece_bb(PieceType::King, position.STM());
+
         int32_t static_eval = -INF;
-        if (!in_check(position, position.STM())) {
-            static_eval = eval::evaluate(accumulator, position.STM());
+        if (!is_check) {
+            static_eval = profile::timed(profile::Category::Evaluate, [&] { return eval::evaluate(accumulator, position.STM()); });
             stack[ply].eval = static_eval;
         } 
 
         bool improving = false;
 
-        if (!in_check(position, position.STM())) {
+        if (!is_check) {
             if (ply > 1 && stack[ply - 2].eval != -INF) {
                 improving = static_eval > stack[ply - 2].eval;
             }
         }
 
-        if (!stack[ply].excluded.data() && !in_check(position, position.STM())) {
-            if (!is_PV && depth <= 5 && static_eval >= beta + std::max(depth - improving, 0) * 100) return static_eval;
+        if (!stack[ply].excluded.data() && !is_check) {
+            if (!is_PV && depth <= 5 && static_eval >= beta + std::max(depth - improving, 0) * 100) return traced(static_eval, trace::Reason::StaticPrune);
 
             if (!is_PV && depth >= 3) {
                 const uint64_t no_pawns_or_kings = position.color_bb(position.STM()) & ~position.piece_bb(PieceType::King, position.STM()) & ~position.piece_bb(PieceType::Pawn, position.STM());
@@ -123,21 +192,24 @@ namespace episteme::search {
                     stack[ply].move = Move();
                     stack[ply].piece = Piece::None;
 
-                    position.make_null();
+                    if constexpr (stats::ENABLED) stats::counters.null_attempts++;
+
+                    profile::timed(profile::Category::MakeMove, [&] { position.make_null(); });
                     int32_t score = -search<false>(position, null, depth - reduction, ply + 1, -beta, -beta + 1, limits);
-                    position.unmake_move();
+                    profile::timed(profile::Category::UnmakeMove, [&] { position.unmake_move(); });
 
-                    if (should_stop) return 0;
+                    if (should_stop) return traced(0, trace::Reason::Stopped);
 
                     if (score >= beta) {
-                        if (std::abs(score) >= MATE - MAX_SEARCH_PLY) return beta;
-                        return score;
+                        if constexpr (stats::ENABLED) stats::counters.null_cutoffs++;
+                        if (std::abs(score) >= MATE - MAX_SEARCH_PLY) return traced(beta, trace::Reason::NullCutoff);
+                        return traced(score, trace::Reason::NullCutoff);
                     }
                 }
             }
         }
 
-        ScoredList move_list = generate_scored_moves(position, tt_entry, ply);
+        ScoredList move_list = generate_scored_moves(position, tt_entry, ply, threats);
         int32_t best = -INF;
 
         MoveList explored_quiets;
@@ -146,7 +218,7 @@ namespace episteme::search {
 
         for (size_t i = 0; i < move_list.count; i++) { 
             pick_move(move_list, i);
-            Move move = move_list.list[i].move;
+            Move move = move_list.move(i);
             Piece piece = position.mailbox(move.from_square());
 
             bool is_quiet = position.mailbox(move.to_square()) == Piece::None && move.move_type() != MoveType::EnPassant;
@@ -156,10 +228,13 @@ namespace episteme::search {
                 if (is_quiet && num_legal >= lmp_threshold) break;
 
                 const int32_t fp_margin = depth * 250;
-                if (!is_PV && is_quiet && !in_check(position, position.STM()) && static_eval + fp_margin <= alpha) break;
+                if (!is_PV && is_quiet && !is_check && static_eval + fp_margin <= alpha) break;
 
+                // A cached SEE pass at threshold 0 implies a pass at any lower threshold
                 const int32_t see_threshold = (is_quiet) ? -60 * depth : -30 * depth * depth;
-                if (!is_PV && !eval::SEE(position, move, see_threshold)) continue;
+                const bool cached_see = is_good_capture(move_list.score(i));
+                if (!is_PV && !(cached_see && see_threshold <= 0)
+                    && !profile::timed(profile::Category::SEE, [&] { return eval::SEE(position, move, see_threshold, threats); })) continue;
             }
 
             if (move.data() == stack[ply].excluded.data()) continue;
@@ -169,22 +244,27 @@ namespace episteme::search {
                 const int32_t new_beta = std::max(-INF + 1, tt_entry.score - depth * 2);
                 const int16_t new_depth = (depth - 1) / 2;
 
+                if constexpr (stats::ENABLED) stats::counters.singular_searches++;
+
                 stack[ply].excluded = move;
                 int32_t score = search<false>(position, PV, new_depth, ply, new_beta - 1, new_beta, limits);
                 stack[ply].excluded = Move();
 
-                if (should_stop) return 0;
+                if (should_stop) return traced(0, trace::Reason::Stopped);
 
-                if (score < new_beta) extension = 1;
-                else if (new_beta >= beta && std::abs(score) < MATE - MAX_SEARCH_PLY) return new_beta;
+                if (score < new_beta) {
+                    extension = 1;
+                    if constexpr (stats::ENABLED) stats::counters.singular_extensions++;
+                }
+                else if (new_beta >= beta && std::abs(score) < MATE - MAX_SEARCH_PLY) return traced(new_beta, trace::Reason::SingularCutoff);
             }
 
-            accumulator = eval::update(position, move, accumulator);
+            accumulator = profile::timed(profile::Category::Update, [&] { return eval::update(position, move, accumulator); });
             accum_history.emplace_back(accumulator);
-            position.make_move(move);
+            profile::timed(profile::Category::MakeMove, [&] { position.make_move(move); });
 
             if (in_check(position, position.NTM())) {
-                position.unmake_move();
+                profile::timed(profile::Category::UnmakeMove, [&] { position.unmake_move(); });
                 accum_history.pop_back();
                 accumulator = accum_history.back();
 
@@ -205,7 +285,7 @@ namespace episteme::search {
                 stack[ply].move = Move();
                 stack[ply].piece = Piece::None;
 
-                return 0;
+                return traced(0, trace::Reason::Stopped);
             };
 
             Line candidate = {};
@@ -216,8 +296,15 @@ namespace episteme::search {
                 int16_t reduction = lmr_table[depth][num_legal] + !improving;
                 int16_t reduced = std::min(std::max(new_depth - reduction, 1), static_cast<int>(new_depth));
 
+                if constexpr (stats::ENABLED) stats::counters.lmr_searches++;
+
                 score = -search<false>(position, candidate, reduced, ply + 1, -alpha - 1, -alpha, limits);
                 if (score > alpha && reduced < depth - 1) {
+                    if constexpr (stats::ENABLED) stats::counters.lmr_researches++;
+                    if constexpr (trace::ENABLED) {
+                        if (tracer.active()) tracer.write(trace::Kind::LMRResearch, trace::Reason::None, move, ply, new_depth, alpha, alpha + 1, score);
+                    }
+
                     score = -search<false>(position, candidate, new_depth, ply + 1, -alpha - 1, -alpha, limits);
                 }
             } else if (!is_PV || num_legal > 1) {
@@ -225,17 +312,21 @@ namespace episteme::search {
             }
 
             if (is_PV && (num_legal == 1 || score > alpha)) {
+                if constexpr (trace::ENABLED) {
+                    if (tracer.active() && num_legal > 1) tracer.write(trace::Kind::PVSResearch, trace::Reason::None, move, ply, new_depth, alpha, beta, score);
+                }
+
                 score = -search<true>(position, candidate, new_depth, ply + 1, -beta, -alpha, limits);
             }
 
-            position.unmake_move();
+            profile::timed(profile::Category::UnmakeMove, [&] { position.unmake_move(); });
             accum_history.pop_back();
             accumulator = accum_history.back();
 
             stack[ply].move = Move();
             stack[ply].piece = Piece::None;
             
-            if (should_stop) return 0;
+            if (should_stop) return traced(0, trace::Reason::Stopped);
             
             if (score > best) {
                 best = score;
@@ -248,6 +339,8 @@ namespace episteme::search {
                 PV.update_line(move, candidate);
 
                 if (score >= beta) {
+                    if constexpr (stats::ENABLED) stats::counters.add_cutoff(num_legal - 1);
+
                     if (is_quiet) {
                         stack[ply].killer = move;
 
@@ -270,7 +363,7 @@ namespace episteme::search {
             }
         };
 
-        if (num_legal == 0) return in_check(position, position.STM()) ? (-MATE + ply) : 0;
+        if (num_legal == 0) return traced(is_check ? (-MATE + ply) : 0, trace::Reason::NoMoves);
 
         if (!stack[ply].excluded.data()) {
             ttable.add({
@@ -282,31 +375,48 @@ namespace episteme::search {
             });    
         }
 
-        return best;
+        return traced(best, (node_type == tt::NodeType::CutNode) ? trace::Reason::BetaCutoff
+            : (node_type == tt::NodeType::PVNode) ? trace::Reason::Exact : trace::Reason::FailLow);
     }
 
     int32_t Worker::quiesce(Position& position, Line& PV, int16_t ply, int32_t alpha, int32_t beta, SearchLimits limits) {
+        const int32_t entry_alpha = alpha;
+        auto traced = [&](int32_t score, trace::Reason reason) {
+            if constexpr (trace::ENABLED) {
+                if (tracer.active()) tracer.write(trace::Kind::QSearch, reason, (ply > 0) ? stack[ply - 1].move : Move(), ply, 0, entry_alpha, beta, score);
+            }
+            return score;
+        };
+
         if (nodes % 2000 == 0 && limits.time_exceeded()) {
             should_stop = true;
-            return 0;
+            return traced(0, trace::Reason::Stopped);
         };
         
-        tt::Entry tt_entry = ttable.probe(position.zobrist());
+        tt::Entry tt_entry = profile::timed(profile::Category::TTProbe, [&] { return ttable.probe(position.zobrist()); });
+
+        if constexpr (stats::ENABLED) {
+            stats::counters.qsearch_nodes++;
+            stats::counters.tt_probes++;
+            stats::counters.tt_hits += tt_entry.node_type != tt::NodeType::None;
+        }
+
         if ((tt_entry.node_type == tt::NodeType::PVNode)
             || (tt_entry.node_type == tt::NodeType::AllNode && tt_entry.score <= alpha)
             || (tt_entry.node_type == tt::NodeType::CutNode && tt_entry.score >= beta)
         ) {
-            return tt_entry.score;
+            if constexpr (stats::ENABLED) stats::counters.tt_cutoffs++;
+            return traced(tt_entry.score, trace::Reason::TTCutoff);
         }
 
-        int32_t eval = eval::evaluate(accumulator, position.STM());
+        int32_t eval = profile::timed(profile::Category::Evaluate, [&] { return eval::evaluate(accumulator, position.STM()); });
 
         int32_t best = eval;
         if (best > alpha) {
             alpha = best;
 
             if (best >= beta) {
-                return best;
+                return traced(best, trace::Reason::StandPat);
             }
         };
 
@@ -315,16 +425,20 @@ namespace episteme::search {
 
         for (size_t i = 0; i < captures_list.count; i++) {
             pick_move(captures_list, i);
-            Move move = captures_list.list[i].move;
+            Move move = captures_list.move(i);
 
-            if (!eval::SEE(position, move, 0)) continue;
+            const int16_t move_score = captures_list.score(i);
+            const bool see = (move_score == TT_MOVE_SCORE)
+                ? profile::timed(profile::Category::SEE, [&] { return eval::SEE(position, move, 0); })
+                : is_good_capture(move_score);
+            if (!see) continue;
 
-            accumulator = eval::update(position, move, accumulator);
+            accumulator = profile::timed(profile::Category::Update, [&] { return eval::update(position, move, accumulator); });
             accum_history.emplace_back(accumulator);
-            position.make_move(move);
+            profile::timed(profile::Category::MakeMove, [&] { position.make_move(move); });
 
             if (in_check(position, position.NTM())) {
-                position.unmake_move();
+                profile::timed(profile::Category::UnmakeMove, [&] { position.unmake_move(); });
                 accum_history.pop_back();
                 accumulator = accum_history.back();
 
@@ -336,17 +450,21 @@ namespace episteme::search {
             if (limits.node_exceeded(nodes)) {
                 should_stop = true;
                 position.unmake_move();
-                return 0;
+                return traced(0, trace::Reason::Stopped);
             };
 
+            if constexpr (trace::ENABLED) stack[ply].move = move;
+
             Line candidate = {};
             int32_t score = -quiesce(position, candidate, ply + 1, -beta, -alpha, limits);
 
-            position.unmake_move();
+            if constexpr (trace::ENABLED) stack[ply].move = Move();
+
+            profile::timed(profile::Category::UnmakeMove, [&] { position.unmake_move(); });
             accum_history.pop_back();
             accumulator = accum_history.back();
             
-            if (should_stop) return 0;
+            if (should_stop) return traced(0, trace::Reason::Stopped);
 
             if (score > best) {
                 best = score;
@@ -373,11 +491,13 @@ namespace episteme::search {
             .node_type = node_type
         });
 
-        return best;
+        return traced(best, (node_type == tt::NodeType::CutNode) ? trace::Reason::BetaCutoff
+            : (node_type == tt::NodeType::PVNode) ? trace::Reason::Exact : trace::Reason::FailLow);
     }
 
     Report Worker::run(int32_t last_score, const Parameters& params, Position& position, const SearchLimits& limits, bool is_absolute) {
         accumulator = eval::reset(position);
+        accum_history.clear();
         accum_history.emplace_back(accumulator);
 
         Line PV{};
@@ -387,6 +507,8 @@ namespace episteme::search {
         int32_t alpha = (depth == 1) ? -MATE : last_score - delta;
         int32_t beta = (depth == 1) ? MATE : last_score + delta;
 
+        profile::Scope scope(profile::Category::Search);
+
         auto start = steady_clock::now();
         int32_t score = search<true>(position, PV, depth, 0, alpha, beta, limits);
 
@@ -420,29 +542,33 @@ namespace episteme::search {
         return eval::evaluate(accumulator, position.STM());
     }
 
-    void Worker::bench(int depth) {
-        uint64_t total = 0;
-        milliseconds elapsed = 0ms;
-        for (std::string fen : fens) {
-            Line PV = {};
-            Position position;
+    BenchSample Worker::bench_position(const std::string& fen, int depth, perf::Counters* counters) {
+        Line PV = {};
+        Position position;
+        position.from_FEN(fen);
 
-            position.from_FEN(fen);
-            accumulator = eval::reset(position);
-            accum_history.emplace_back(accumulator);
+        ttable.reset();
+        history.reset();
+        stack.reset();
 
-            nodes = 0;
+        accumulator = eval::reset(position);
+        accum_history.clear();
+        accum_history.emplace_back(accumulator);
 
-            auto start = steady_clock::now();
-            (void)search<true>(position, PV, depth, 0, -INF, INF);
-            auto end = steady_clock::now();
+        nodes = 0;
+        should_stop = false;
 
-            elapsed += duration_cast<milliseconds>(end - start);
-            total += nodes;
-        }
+        const alloc::Counts allocs_before = alloc::thread_counts();
 
-        int64_t nps = elapsed.count() > 0 ? 1000 * total / elapsed.count() : 0;
-        std::cout << total << " nodes " << nps << " nps" << std::endl;
+        if (counters) counters->start();
+        auto start = steady_clock::now();
+        profile::timed(profile::Category::Search, [&] { (void)search<true>(position, PV, depth, 0, -INF, INF); });
+        int64_t elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+        perf::Sample sample = counters ? counters->stop() : perf::Sample{};
+
+        const uint64_t allocations = (alloc::thread_counts() - allocs_before).allocations;
+
+        return {.nodes = nodes, .time = elapsed, .perf = sample, .allocations = allocations};
     }
 
     void Engine::run(Position& position) {
@@ -451,20 +577,29 @@ namespace episteme::search {
         int32_t time = params.time[color_idx(position.STM())];
         int32_t inc  = params.inc[color_idx(position.STM())];
 
+        const auto go_start = steady_clock::now();
+        const int64_t hard_us = time ? 1000 * static_cast<int64_t>(time / 20 + inc / 2) : 0;
+
         SearchLimits limits;
         if (target_nodes) limits.max_nodes = target_nodes;
-        if (time)limits.end = steady_clock::now() + milliseconds(time / 20 + inc / 2);
+        if (time) limits.end = go_start + microseconds(hard_us);
 
         worker.reset_nodes();
+        stats::counters.clear();
+        profile::timings.clear();
 
         Report last_report;
         int32_t last_score = 0;
+        alloc::Counts search_allocs{};
 
         for (int depth = 1; depth <= max_depth; depth++) {
             Parameters iter_params = params;
             iter_params.depth = depth;
 
+            const alloc::Counts allocs_before = alloc::thread_counts();
             Report report = worker.run(last_score, iter_params, position, limits, false);
+            search_allocs += alloc::thread_counts() - allocs_before;
+
             if (worker.stopped()) break;
 
             last_report = report;
@@ -486,6 +621,26 @@ namespace episteme::search {
             std::cout << std::endl;
         }
     
+        if constexpr (profile::ENABLED) profile::timings.print();
+
+        // Only searches are counted, output is left out; the first go may still be sizing buffers
+        if constexpr (alloc::ENABLED) {
+            std::cout << "info string allocations " << search_allocs.allocations << " bytes " << search_allocs.bytes << std::endl;
+            assert(!warmed_up || search_allocs.allocations == 0);
+            warmed_up = true;
+        }
+
+        // Iterations are only cut off by the hard deadline today, so the soft budget is the same
+        const auto bestmove_time = steady_clock::now();
+        telemetry::Go go{
+            .soft_us = hard_us,
+            .hard_us = hard_us,
+            .elapsed_us = duration_cast<microseconds>(bestmove_time - go_start).count(),
+            .stop_latency_us = std::nullopt
+        };
+        if (limits.end && bestmove_time >= *limits.end) go.stop_latency_us = duration_cast<microseconds>(bestmove_time - *limits.end).count();
+        telemetry.record(go);
+
         Move best = last_report.line.moves[0];
         std::cout << "bestmove " << best.to_string() << std::endl;
     }
@@ -527,7 +682,552 @@ namespace episteme::search {
         std::cout << "info score cp " << worker.eval(position) << std::endl;
     }
 
-    void Engine::bench(int depth) {
-        worker.bench(depth);
+    void Worker::memory_regions(std::vector<memory::Region>& regions) const {
+        regions.push_back({"history", &history, sizeof(history), memory::Scope::PerThread});
+        regions.push_back({"stack", &stack, sizeof(stack), memory::Scope::PerThread});
+        regions.push_back({"accumulators", accum_history.data(), accum_history.capacity() * sizeof(nn::Accumulator), memory::Scope::PerThread});
+    }
+
+    void Engine::memory(uint16_t num_threads, uint32_t hash_size) const {
+        std::vector<memory::Region> regions;
+
+        regions.push_back({"tt", ttable.data(), ttable.bytes(), memory::Scope::Hash});
+        worker.memory_regions(regions);
+
+        // Only the compiled slider backend's tables are ever read outside sliderbench
+        constexpr memory::Scope magic_scope = (SLIDER_BACKEND == SliderBackend::Magic) ? memory::Scope::Shared : memory::Scope::Unused;
+        constexpr memory::Scope pext_scope = (SLIDER_BACKEND == SliderBackend::Pext) ? memory::Scope::Shared : memory::Scope::Unused;
+
+        regions.push_back({"rook_attacks", ROOK_ATTACKS.data(), sizeof(ROOK_ATTACKS), magic_scope});
+        regions.push_back({"bishop_attacks", BISHOP_ATTACKS.data(), sizeof(BISHOP_ATTACKS), magic_scope});
+        regions.push_back({"rook_pext_attacks", ROOK_PEXT_ATTACKS.data(), sizeof(ROOK_PEXT_ATTACKS), pext_scope});
+        regions.push_back({"bishop_pext_attacks", BISHOP_PEXT_ATTACKS.data(), sizeof(BISHOP_PEXT_ATTACKS), pext_scope});
+        regions.push_back({"network", eval::network(), sizeof(nn::NNUE), memory::Scope::Shared});
+
+        const size_t hash_bytes = static_cast<size_t>(hash_size) * 1024 * 1024 / sizeof(tt::Entry) * sizeof(tt::Entry);
+        memory::report(regions, num_threads, hash_size, hash_bytes);
+    }
+
+    bool pin_thread(int32_t cpu) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu, &cpu_set);
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+    }
+
+    BenchResult run_bench(int depth, uint16_t num_threads, uint32_t hash_size, std::optional<int32_t> pin_cpu, bool perf) {
+        num_threads = std::max<uint16_t>(num_threads, 1);
+
+        BenchResult result;
+        result.samples.resize(fens.size());
+        std::atomic<size_t> next_fen = 0;
+
+        std::vector<profile::Timings> thread_timings(num_threads);
+        std::vector<stats::Counters> thread_counters(num_threads);
+
+        auto bench_thread = [&](uint16_t thread_idx) {
+            if (pin_cpu && !pin_thread(*pin_cpu + thread_idx)) {
+                std::cout << "info string could not pin thread to cpu " << *pin_cpu + thread_idx << std::endl;
+            }
+
+            auto ttable = std::make_unique<tt::Table>(hash_size);
+            auto worker = std::make_unique<Worker>(*ttable);
+
+            // Counters only follow the thread that opened them, so each bench thread needs its own
+            std::optional<perf::Counters> counters;
+            if (perf) counters.emplace();
+
+            size_t i;
+            while ((i = next_fen.fetch_add(1, std::memory_order_relaxed)) < fens.size()) {
+                result.samples[i] = worker->bench_position(fens[i], depth, counters ? &*counters : nullptr);
+            }
+
+            if constexpr (profile::ENABLED) {
+                if (thread_idx) thread_timings[thread_idx] = profile::timings;
+            }
+            if constexpr (stats::ENABLED) {
+                if (thread_idx) thread_counters[thread_idx] = stats::counters;
+            }
+        };
+
+        auto start = steady_clock::now();
+
+        std::vector<std::thread> threads;
+        for (uint16_t i = 1; i < num_threads; i++) {
+            threads.emplace_back(bench_thread, i);
+        }
+
+        bench_thread(0);
+        for (auto& thread : threads) thread.join();
+
+        result.wall_time = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+        // Helper threads exit with their timings and counters, so fold them into the calling thread's
+        if constexpr (profile::ENABLED) {
+            for (uint16_t i = 1; i < num_threads; i++) profile::timings += thread_timings[i];
+        }
+        if constexpr (stats::ENABLED) {
+            for (uint16_t i = 1; i < num_threads; i++) stats::counters += thread_counters[i];
+        }
+
+        return result;
+    }
+
+    Summary summarize(std::vector<double> values) {
+        Summary summary;
+        if (values.empty()) return summary;
+
+        std::sort(values.begin(), values.end());
+        size_t mid = values.size() / 2;
+
+        summary.median = (values.size() % 2) ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+        summary.mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+        summary.min = values.front();
+        summary.max = values.back();
+
+        if (values.size() > 1) {
+            double sum_squares = 0;
+            for (double value : values) sum_squares += (value - summary.mean) * (value - summary.mean);
+            summary.stddev = std::sqrt(sum_squares / (values.size() - 1));
+        }
+
+        return summary;
+    }
+
+    namespace {
+        // Single-threaded benches pin the calling thread itself; its affinity is restored on destruction
+        class BenchAffinity {
+            public:
+                explicit BenchAffinity(const BenchOptions& options) : pinned_main(options.pin_cpu && options.num_threads <= 1), pin_cpu(options.pin_cpu) {
+                    pthread_getaffinity_np(pthread_self(), sizeof(initial_affinity), &initial_affinity);
+
+                    if (pinned_main && !pin_thread(*pin_cpu)) {
+                        std::cout << "info string could not pin bench thread to cpu " << *pin_cpu << std::endl;
+                    }
+                }
+
+                ~BenchAffinity() {
+                    pthread_setaffinity_np(pthread_self(), sizeof(initial_affinity), &initial_affinity);
+                }
+
+                [[nodiscard]] std::optional<int32_t> thread_pin() const {
+                    return pinned_main ? std::nullopt : pin_cpu;
+                }
+
+            private:
+                cpu_set_t initial_affinity;
+                bool pinned_main;
+                std::optional<int32_t> pin_cpu;
+        };
+
+        std::vector<BenchResult> measure(const BenchOptions& options, uint16_t num_threads, std::optional<int32_t> thread_pin) {
+            for (int32_t i = 0; i < options.warmup; i++) {
+                (void)run_bench(options.depth, num_threads, options.hash_size, thread_pin, options.perf);
+            }
+
+            // Warmup searches shouldn't show up in stats or profile output
+            stats::counters.clear();
+            profile::timings.clear();
+
+            std::vector<BenchResult> runs;
+            for (int32_t i = 0; i < std::max(options.repetitions, 1); i++) {
+                runs.push_back(run_bench(options.depth, num_threads, options.hash_size, thread_pin, options.perf));
+            }
+
+            return runs;
+        }
+
+        // A single thread is rated on search time alone, threaded runs on wall time
+        double run_nps(const BenchResult& run, uint16_t num_threads) {
+            return static_cast<double>(num_threads > 1 ? run.wall_nps() : run.nps());
+        }
+
+        std::vector<double> nps_samples(const std::vector<BenchResult>& runs, uint16_t num_threads) {
+            std::vector<double> samples;
+            for (const BenchResult& run : runs) samples.push_back(run_nps(run, num_threads));
+            return samples;
+        }
+
+        benchlog::Entry history_entry(const BenchOptions& options, const std::vector<BenchResult>& runs, uint16_t num_threads) {
+            benchlog::Entry entry{
+                .timestamp = duration_cast<seconds>(system_clock::now().time_since_epoch()).count(),
+                .commit = options.commit.empty() ? "unknown" : options.commit,
+                .hardware = benchlog::hardware_fingerprint(),
+                .depth = options.depth,
+                .num_threads = num_threads,
+                .hash_size = options.hash_size,
+                .nodes = runs.front().total_nodes(),
+                .nps = nps_samples(runs, num_threads),
+                .perf = {},
+                .perf_nodes = 0
+            };
+
+            for (const BenchResult& run : runs) {
+                entry.perf += run.total_perf();
+                entry.perf_nodes += run.total_nodes();
+            }
+
+            return entry;
+        }
+
+        void record_history(const BenchOptions& options, const std::vector<BenchResult>& runs, uint16_t num_threads) {
+            if (options.history_path.empty()) return;
+
+            if (!benchlog::append(options.history_path, history_entry(options, runs, num_threads))) {
+                std::cout << "info string could not write bench history to " << options.history_path << std::endl;
+            }
+        }
+    }
+
+    void bench(const BenchOptions& options) {
+        stats::counters.clear();
+        profile::timings.clear();
+
+        std::optional<BenchAffinity> affinity(std::in_place, options);
+
+        auto collect = [](const std::vector<BenchResult>& runs, auto value) {
+            std::vector<double> values;
+            for (const BenchResult& run : runs) values.push_back(value(run));
+            return summarize(values);
+        };
+
+        const uint16_t num_threads = std::max<uint16_t>(options.num_threads, 1);
+        std::vector<BenchResult> runs = measure(options, num_threads, affinity->thread_pin());
+
+        const uint64_t signature = runs.front().total_nodes();
+        const bool deterministic = std::all_of(runs.begin(), runs.end(), [&](const BenchResult& run) { return run.total_nodes() == signature; });
+
+        Summary nps = summarize(nps_samples(runs, num_threads));
+        Summary wall = collect(runs, [](const BenchResult& run) { return static_cast<double>(run.wall_time); });
+
+        std::optional<Summary> baseline_wall;
+        if (num_threads > 1) {
+            // The one-thread baseline runs on this thread too, so keep it out of the measured run's counters
+            const stats::Counters measured_counters = stats::counters;
+            const profile::Timings measured_timings = profile::timings;
+
+            baseline_wall = collect(measure(options, 1, affinity->thread_pin()), [](const BenchResult& run) { return static_cast<double>(run.wall_time); });
+
+            stats::counters = measured_counters;
+            profile::timings = measured_timings;
+        }
+
+        // Positions are searched independently, so the wall time ratio is both the nps and the time-to-depth speedup
+        double speedup = (baseline_wall && wall.median > 0) ? baseline_wall->median / wall.median : 1.0;
+
+        std::vector<Summary> positions;
+        for (size_t i = 0; i < fens.size(); i++) {
+            positions.push_back(collect(runs, [&](const BenchResult& run) { return static_cast<double>(run.samples[i].time); }));
+        }
+
+        affinity.reset();
+        record_history(options, runs, num_threads);
+
+        perf::Sample perf_total;
+        double perf_nodes = 0;
+        for (const BenchResult& run : runs) {
+            perf_total += run.total_perf();
+            perf_nodes += run.total_nodes();
+        }
+
+        auto position_nps = [&](size_t i) {
+            return static_cast<uint64_t>(positions[i].median > 0 ? 1e9 * runs.front().samples[i].nodes / positions[i].median : 0);
+        };
+
+        if (options.json) {
+            std::cout << "{\"depth\":" << options.depth
+                << ",\"threads\":" << num_threads
+                << ",\"hash\":" << options.hash_size
+                << ",\"warmup\":" << options.warmup
+                << ",\"repetitions\":" << runs.size()
+                << ",\"nodes\":" << signature
+                << ",\"deterministic\":" << (deterministic ? "true" : "false")
+                << ",\"nps\":{\"median\":" << static_cast<uint64_t>(nps.median)
+                << ",\"mean\":" << static_cast<uint64_t>(nps.mean)
+                << ",\"stddev\":" << static_cast<uint64_t>(nps.stddev)
+                << ",\"min\":" << static_cast<uint64_t>(nps.min)
+                << ",\"max\":" << static_cast<uint64_t>(nps.max) << "}"
+                << ",\"wall_ns\":{\"median\":" << static_cast<int64_t>(wall.median) << ",\"stddev\":" << static_cast<int64_t>(wall.stddev) << "}";
+            if (baseline_wall) std::cout << ",\"speedup\":" << speedup << ",\"efficiency\":" << speedup / num_threads;
+            if (options.allocs && alloc::ENABLED) std::cout << ",\"allocations\":" << runs.front().total_allocations();
+            if (options.perf) {
+                std::cout << ",\"perf\":";
+                perf::print_json(std::cout, perf_total, perf_nodes);
+            }
+            std::cout << ",\"positions\":[";
+            for (size_t i = 0; i < fens.size(); i++) {
+                std::cout << (i ? "," : "") << "{\"nodes\":" << runs.front().samples[i].nodes
+                    << ",\"time_ns\":" << static_cast<int64_t>(positions[i].median)
+                    << ",\"stddev_ns\":" << static_cast<int64_t>(positions[i].stddev)
+                    << ",\"nps\":" << position_nps(i) << "}";
+            }
+            std::cout << "]}" << std::endl;
+            return;
+        }
+
+        for (size_t i = 0; i < fens.size(); i++) {
+            std::cout << "info position " << i + 1
+                << " nodes " << runs.front().samples[i].nodes
+                << " time " << static_cast<int64_t>(positions[i].median) << " ns"
+                << " nps " << position_nps(i) << "\n";
+        }
+
+        std::cout << "info threads " << num_threads << " repetitions " << runs.size()
+            << " nps median " << static_cast<uint64_t>(nps.median)
+            << " mean " << static_cast<uint64_t>(nps.mean)
+            << " stddev " << static_cast<uint64_t>(nps.stddev)
+            << " min " << static_cast<uint64_t>(nps.min)
+            << " max " << static_cast<uint64_t>(nps.max);
+        if (baseline_wall) std::cout << " speedup " << speedup << " efficiency " << 100 * speedup / num_threads << "%";
+        if (!deterministic) std::cout << " nodes mismatch";
+        std::cout << "\n";
+
+        if (options.allocs) {
+            if constexpr (alloc::ENABLED) std::cout << "info allocations " << runs.front().total_allocations() << " during search\n";
+            else std::cout << "info string allocation counting disabled, rebuild with EPISTEME_ALLOC_COUNT\n";
+        }
+
+        if (options.perf) {
+            if (perf_total.any()) {
+                std::cout << "info perf";
+                perf::print_rates(std::cout, perf_total, perf_nodes, "node");
+                std::cout << "\n";
+            } else {
+                std::cout << "info string perf counters unavailable\n";
+            }
+        }
+
+        if constexpr (profile::ENABLED) profile::timings.print();
+
+        std::cout << signature << " nodes " << static_cast<uint64_t>(nps.median) << " nps" << std::endl;
+    }
+
+    void bench_compare(const BenchOptions& options, const std::string& path, const std::string& baseline_commit) {
+        const uint16_t num_threads = std::max<uint16_t>(options.num_threads, 1);
+        const std::string hardware = benchlog::hardware_fingerprint();
+
+        std::vector<double> baseline;
+        uint64_t baseline_nodes = 0;
+        std::string baseline_name;
+
+        // Without a commit the most recent matching entry is the baseline, otherwise all of that commit's samples are pooled
+        for (const benchlog::Entry& entry : benchlog::load(path)) {
+            if (entry.depth != options.depth || entry.num_threads != num_threads || entry.hash_size != options.hash_size || entry.hardware != hardware) continue;
+            if (!baseline_commit.empty() && entry.commit != baseline_commit) continue;
+
+            if (baseline_commit.empty()) baseline.clear();
+            baseline.insert(baseline.end(), entry.nps.begin(), entry.nps.end());
+            baseline_nodes = entry.nodes;
+            baseline_name = entry.commit;
+        }
+
+        if (baseline.empty()) {
+            std::cout << "info string no baseline for depth " << options.depth << " threads " << num_threads << " hash " << options.hash_size
+                << (baseline_commit.empty() ? "" : " commit " + baseline_commit) << " on this machine in " << path << std::endl;
+            return;
+        }
+
+        std::vector<BenchResult> runs;
+        {
+            BenchAffinity affinity(options);
+            runs = measure(options, num_threads, affinity.thread_pin());
+        }
+
+        record_history(options, runs, num_threads);
+
+        const uint64_t nodes = runs.front().total_nodes();
+        std::cout << "info baseline " << baseline_name << " samples " << baseline.size() << " nodes " << baseline_nodes
+            << " current samples " << runs.size() << " nodes " << nodes << std::endl;
+        if (nodes != baseline_nodes) std::cout << "info string node counts differ, search behaviour changed since the baseline" << std::endl;
+
+        benchlog::print_comparison(benchlog::compare(baseline, nps_samples(runs, num_threads)), "baseline", "current");
+    }
+
+    void bench_networks(const BenchOptions& options, const std::string& path) {
+        std::unique_ptr<nn::NNUE> candidate = eval::load_network(path);
+        if (!candidate) {
+            std::cout << "info string could not load network " << path << std::endl;
+            return;
+        }
+
+        const uint16_t num_threads = std::max<uint16_t>(options.num_threads, 1);
+        const nn::NNUE* networks[2] = {eval::embedded_network(), candidate.get()};
+
+        std::array<std::vector<double>, 2> samples;
+        std::array<uint64_t, 2> nodes{};
+
+        {
+            BenchAffinity affinity(options);
+
+            auto run_with = [&](size_t idx) {
+                eval::set_network(networks[idx]);
+                BenchResult run = run_bench(options.depth, num_threads, options.hash_size, affinity.thread_pin(), options.perf);
+                nodes[idx] = run.total_nodes();
+                return run_nps(run, num_threads);
+            };
+
+            for (int32_t i = 0; i < options.warmup; i++) {
+                (void)run_with(0);
+                (void)run_with(1);
+            }
+
+            // Alternating the order each round (ABBA) keeps slow drift such as heating from favouring either network
+            for (int32_t i = 0; i < std::max(options.repetitions, 1); i++) {
+                const size_t first = i % 2;
+                samples[first].push_back(run_with(first));
+                samples[1 - first].push_back(run_with(1 - first));
+            }
+
+            eval::set_network(networks[0]);
+        }
+
+        std::cout << "info network embedded nodes " << nodes[0] << " nps median " << static_cast<uint64_t>(summarize(samples[0]).median) << "\n"
+            << "info network " << path << " nodes " << nodes[1] << " nps median " << static_cast<uint64_t>(summarize(samples[1]).median) << std::endl;
+
+        benchlog::print_comparison(benchlog::compare(samples[0], samples[1]), "embedded", "candidate");
+    }
+
+    namespace {
+        // The lookups are inlined into each sweep, so the timings compare table accesses rather than calls
+        uint64_t sweep_magic(const std::vector<uint64_t>& occupancies, int rounds) {
+            uint64_t sum = 0;
+            for (int round = 0; round < rounds; round++) {
+                for (uint64_t occupancy : occupancies) {
+                    for (int sq = 0; sq < 64; sq++) sum += get_rook_attacks_magic(sq_from_idx(sq), occupancy) ^ get_bishop_attacks_magic(sq_from_idx(sq), occupancy);
+                }
+            }
+            return sum;
+        }
+
+        __attribute__((target("bmi2"))) uint64_t sweep_pext(const std::vector<uint64_t>& occupancies, int rounds) {
+            uint64_t sum = 0;
+            for (int round = 0; round < rounds; round++) {
+                for (uint64_t occupancy : occupancies) {
+                    for (int sq = 0; sq < 64; sq++) sum += get_rook_attacks_pext(sq_from_idx(sq), occupancy) ^ get_bishop_attacks_pext(sq_from_idx(sq), occupancy);
+                }
+            }
+            return sum;
+        }
+    }
+
+    void bench_sliders(Position& position, int32_t depth) {
+        constexpr int SEE_ROUNDS = 200;
+        constexpr int SWEEP_ROUNDS = 2000;
+        constexpr std::array<int32_t, 3> SEE_THRESHOLDS = {-100, 0, 100};
+
+        auto perft_start = steady_clock::now();
+        uint64_t perft_nodes = perft(position, depth);
+        auto perft_elapsed = duration_cast<nanoseconds>(steady_clock::now() - perft_start).count();
+
+        uint64_t see_calls = 0;
+        uint64_t see_passed = 0;
+        nanoseconds see_elapsed = 0ns;
+
+        // Occupancies of the bench positions and every position one move on feed the raw lookup sweep
+        std::vector<uint64_t> occupancies;
+
+        for (const std::string& fen : fens) {
+            Position see_position;
+            see_position.from_FEN(fen);
+
+            MoveList move_list;
+            generate_all_moves(move_list, see_position);
+
+            occupancies.push_back(see_position.total_bb());
+            for (size_t i = 0; i < move_list.count; i++) {
+                see_position.make_move(move_list.list[i]);
+                occupancies.push_back(see_position.total_bb());
+                see_position.unmake_move();
+            }
+
+            auto start = steady_clock::now();
+            for (int round = 0; round < SEE_ROUNDS; round++) {
+                for (size_t i = 0; i < move_list.count; i++) {
+                    for (int32_t threshold : SEE_THRESHOLDS) {
+                        see_passed += eval::SEE(see_position, move_list.list[i], threshold);
+                    }
+                }
+            }
+            see_elapsed += duration_cast<nanoseconds>(steady_clock::now() - start);
+            see_calls += SEE_ROUNDS * move_list.count * SEE_THRESHOLDS.size();
+        }
+
+        int64_t perft_nps = (perft_elapsed > 0) ? 1000000000 * perft_nodes / perft_elapsed : 0;
+        double see_ns = static_cast<double>(see_elapsed.count()) / (see_calls ? see_calls : 1);
+
+        std::cout << "info backend " << slider_backend_name(SLIDER_BACKEND)
+            << " perft " << perft_nodes << " nodes " << perft_nps << " nps"
+            << " see " << see_calls << " calls " << see_passed << " passed " << see_ns << " ns/call" << std::endl;
+
+        const double lookups = 2.0 * 64 * occupancies.size() * SWEEP_ROUNDS;
+
+        auto start = steady_clock::now();
+        const uint64_t magic_sum = sweep_magic(occupancies, SWEEP_ROUNDS);
+        auto magic_elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+        std::cout << "info lookup magic " << magic_elapsed / lookups << " ns/lookup" << std::endl;
+
+        if (!has_pext()) {
+            std::cout << "info string lookup pext unsupported on this cpu" << std::endl;
+            return;
+        }
+
+        start = steady_clock::now();
+        const uint64_t pext_sum = sweep_pext(occupancies, SWEEP_ROUNDS);
+        auto pext_elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+        std::cout << "info lookup pext " << pext_elapsed / lookups << " ns/lookup" << (has_fast_pext() ? "" : " (microcoded on this cpu)") << std::endl;
+
+        if (magic_sum != pext_sum) std::cout << "info string lookup pext mismatch against magic" << std::endl;
+    }
+
+    void bench_fen(int32_t rounds) {
+        Position position;
+        std::array<char, Position::MAX_FEN_SIZE> buffer;
+
+        for (const std::string& fen : fens) {
+            if (position.from_FEN(fen) != FENError::None) {
+                std::cout << "info string fen rejected " << fen << std::endl;
+                return;
+            }
+
+            std::string_view written(buffer.data(), position.write_FEN(buffer.data()));
+            if (written != fen) {
+                std::cout << "info string fen round trip mismatch " << fen << " -> " << written << std::endl;
+                return;
+            }
+        }
+
+        uint64_t checksum = 0;
+
+        auto parse_start = steady_clock::now();
+        for (int32_t round = 0; round < rounds; round++) {
+            for (const std::string& fen : fens) {
+                position.from_FEN(fen);
+                checksum += position.zobrist();
+            }
+        }
+        auto parse_elapsed = duration_cast<nanoseconds>(steady_clock::now() - parse_start).count();
+
+        std::vector<Position> positions(fens.size());
+        for (size_t i = 0; i < fens.size(); i++) {
+            positions[i].from_FEN(fens[i]);
+        }
+
+        auto write_start = steady_clock::now();
+        for (int32_t round = 0; round < rounds; round++) {
+            for (const Position& written_position : positions) {
+                checksum += written_position.write_FEN(buffer.data());
+            }
+        }
+        auto write_elapsed = duration_cast<nanoseconds>(steady_clock::now() - write_start).count();
+
+        uint64_t count = static_cast<uint64_t>(rounds) * fens.size();
+        uint64_t parse_fps = (parse_elapsed > 0) ? 1000000000 * count / parse_elapsed : 0;
+        uint64_t write_fps = (write_elapsed > 0) ? 1000000000 * count / write_elapsed : 0;
+
+        std::cout << "info fens " << count
+            << " parse " << parse_fps << " fens/s"
+            << " write " << write_fps << " fens/s"
+            << " checksum " << checksum << std::endl;
     }
 }
\ No newline at end of file
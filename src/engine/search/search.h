@@ -1,17 +1,30 @@
 #pragma once
 
 #include "../chess/movegen.h"
+#include "../chess/perft.h"
 #include "../evaluation/evaluate.h"
 #include "../../utils/datagen.h"
+#include "../../utils/perf.h"
+#include "../../utils/alloc.h"
+#include "../../utils/memory.h"
+#include "../../utils/benchlog.h"
 #include "ttable.h"
 #include "history.h"
 #include "stack.h"
+#include "stats.h"
+#include "trace.h"
+#include "profile.h"
+#include "telemetry.h"
 
 #include <cstdint>
 #include <chrono>
 #include <algorithm>
 #include <iostream>
 #include <optional>
+#include <numeric>
+#include <memory>
+#include <cmath>
+#include <pthread.h>
 
 namespace episteme::search {
     using namespace std::chrono;
@@ -23,9 +36,17 @@ namespace episteme::search {
         int32_t score = 0;
     };
 
+    constexpr int16_t TT_MOVE_SCORE = 32767;
+    constexpr int16_t GOOD_CAPTURE_SCORE = 20000;
+    constexpr int16_t KILLER_SCORE = 18000;
+
+    [[nodiscard]] inline bool is_good_capture(int16_t score) {
+        return score >= GOOD_CAPTURE_SCORE && score != TT_MOVE_SCORE;
+    }
+
     struct ScoredList {
-        inline void add(const ScoredMove& move) {
-            list[count] = move;
+        inline void add(Move move, int16_t score) {
+            keys[count] = (static_cast<int32_t>(score) << 16) | move.data();
             count++;
         }
 
@@ -34,10 +55,18 @@ namespace episteme::search {
         }
 
         inline void swap(int src_idx, int dst_idx) {
-            std::iter_swap(list.begin() + src_idx, list.begin() + dst_idx);
+            std::iter_swap(keys.begin() + src_idx, keys.begin() + dst_idx);
+        }
+
+        [[nodiscard]] inline Move move(size_t idx) const {
+            return Move(static_cast<uint16_t>(keys[idx] & 0xFFFF));
+        }
+
+        [[nodiscard]] inline int16_t score(size_t idx) const {
+            return static_cast<int16_t>(keys[idx] >> 16);
         }
 
-        std::array<ScoredMove, 256> list;
+        alignas(32) std::array<int32_t, 256> keys;
         size_t count = 0;
     };
 
@@ -51,8 +80,7 @@ namespace episteme::search {
     constexpr int32_t DELTA = 20;
     constexpr int32_t MAX_SEARCH_PLY = 256;
 
-    extern std::array<std::array<int16_t, 64>, 64> lmr_table;
-    void init_lmr_table();
+    extern const std::array<std::array<int16_t, 64>, 64> lmr_table;
 
     struct Parameters {
         std::array<int32_t, 2> time = {};
@@ -110,14 +138,23 @@ namespace episteme::search {
         Line line;
     };
 
+    struct BenchSample {
+        uint64_t nodes = 0;
+        int64_t time = 0;
+        perf::Sample perf;
+        uint64_t allocations = 0;
+    };
+
     class Worker {
         public:
-            Worker(tt::Table& ttable) : ttable(ttable), should_stop(false) {};
+            // Reserving a full line of accumulators keeps make/unmake in search off the heap
+            Worker(tt::Table& ttable) : ttable(ttable), should_stop(false) {
+                accum_history.reserve(MAX_SEARCH_PLY + 1);
+            };
 
             inline void reset_accum() {
                 accumulator = {};
                 accum_history.clear();
-                accum_history.shrink_to_fit();
             }
 
             inline void reset_history() {
@@ -140,13 +177,21 @@ namespace episteme::search {
                 return nodes;
             }
 
-            ScoredMove score_move(const Position& position, const Move& move, const tt::Entry& tt_entry, std::optional<int32_t> ply);
+            inline bool open_trace(const std::string& path, uint32_t size) {
+                return tracer.open(path, size);
+            }
+
+            inline void close_trace() {
+                tracer.close();
+            }
+
+            int16_t score_move(const Position& position, const Move& move, const tt::Entry& tt_entry, std::optional<int32_t> ply, const Threats* threats);
 
             template<typename F>
-            ScoredList generate_scored_targets(const Position& position, F generator, const tt::Entry& tt_entry, std::optional<int32_t> ply = std::nullopt);
+            ScoredList generate_scored_targets(const Position& position, F generator, const tt::Entry& tt_entry, std::optional<int32_t> ply = std::nullopt, const Threats* threats = nullptr);
 
-            inline ScoredList generate_scored_moves(const Position& position, const tt::Entry& tt_entry, int32_t ply) {
-                return generate_scored_targets(position, generate_all_moves, tt_entry, ply);
+            inline ScoredList generate_scored_moves(const Position& position, const tt::Entry& tt_entry, int32_t ply, const Threats& threats) {
+                return generate_scored_targets(position, generate_all_moves, tt_entry, ply, &threats);
             }
         
             inline ScoredList generate_scored_captures(const Position& position, const tt::Entry& tt_entry) {
@@ -160,7 +205,8 @@ namespace episteme::search {
 
             Report run(int32_t last_score, const Parameters& params, Position& position, const SearchLimits& limits, bool is_absolute);
             int32_t eval(Position& position);
-            void bench(int depth);
+            void memory_regions(std::vector<memory::Region>& regions) const;
+            BenchSample bench_position(const std::string& fen, int depth, perf::Counters* counters = nullptr);
 
         private:
             nn::Accumulator accumulator;
@@ -171,6 +217,7 @@ namespace episteme::search {
             tt::Table& ttable;
             hist::Table history;
             stack::Stack stack;
+            trace::Writer tracer;
 
             uint64_t nodes;
 
@@ -208,15 +255,93 @@ namespace episteme::search {
                 worker.reset_stop();
             }
 
+            inline bool start_trace(const std::string& path, uint32_t size) {
+                return worker.open_trace(path, size);
+            }
+
+            inline void stop_trace() {
+                worker.close_trace();
+            }
+
+            [[nodiscard]] inline const telemetry::Session& time_telemetry() const {
+                return telemetry;
+            }
+
             void run(Position& position);
             ScoredMove datagen_search(Position& position);
             void eval(Position& position);
-            void bench(int depth);
+            void memory(uint16_t num_threads, uint32_t hash_size) const;
 
         private:
             tt::Table ttable;
             Parameters params;
 
             Worker worker;
+            bool warmed_up = false;
+            telemetry::Session telemetry;
     };
+
+    struct BenchResult {
+        std::vector<BenchSample> samples;
+        int64_t wall_time = 0;
+
+        [[nodiscard]] inline uint64_t total_nodes() const {
+            return std::accumulate(samples.begin(), samples.end(), uint64_t(0), [](uint64_t sum, const BenchSample& sample) { return sum + sample.nodes; });
+        }
+
+        [[nodiscard]] inline int64_t search_time() const {
+            return std::accumulate(samples.begin(), samples.end(), int64_t(0), [](int64_t sum, const BenchSample& sample) { return sum + sample.time; });
+        }
+
+        [[nodiscard]] inline uint64_t nps() const {
+            int64_t time = search_time();
+            return time > 0 ? static_cast<uint64_t>(1e9 * total_nodes() / time) : 0;
+        }
+
+        [[nodiscard]] inline perf::Sample total_perf() const {
+            perf::Sample total;
+            for (const BenchSample& sample : samples) total += sample.perf;
+            return total;
+        }
+
+        [[nodiscard]] inline uint64_t total_allocations() const {
+            return std::accumulate(samples.begin(), samples.end(), uint64_t(0), [](uint64_t sum, const BenchSample& sample) { return sum + sample.allocations; });
+        }
+
+        [[nodiscard]] inline uint64_t wall_nps() const {
+            return wall_time > 0 ? static_cast<uint64_t>(1e9 * total_nodes() / wall_time) : 0;
+        }
+    };
+
+    struct BenchOptions {
+        int depth = 10;
+        uint16_t num_threads = 1;
+        uint32_t hash_size = 32;
+        int32_t warmup = 0;
+        int32_t repetitions = 1;
+        std::optional<int32_t> pin_cpu;
+        bool json = false;
+        bool perf = false;
+        bool allocs = false;
+        std::string history_path;
+        std::string commit;
+    };
+
+    struct Summary {
+        double median = 0;
+        double mean = 0;
+        double stddev = 0;
+        double min = 0;
+        double max = 0;
+    };
+
+    bool pin_thread(int32_t cpu);
+    BenchResult run_bench(int depth, uint16_t num_threads, uint32_t hash_size, std::optional<int32_t> pin_cpu = std::nullopt, bool perf = false);
+    Summary summarize(std::vector<double> values);
+    void bench(const BenchOptions& options);
+    void bench_compare(const BenchOptions& options, const std::string& path, const std::string& baseline_commit);
+    void bench_networks(const BenchOptions& options, const std::string& path);
+
+    void bench_sliders(Position& position, int32_t depth);
+    void bench_fen(int32_t rounds);
 }
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+namespace episteme::stats {
+#ifdef EPISTEME_STATS
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    constexpr size_t CUTOFF_BUCKETS = 16;
+
+    struct Counters {
+        uint64_t search_nodes = 0;
+        uint64_t qsearch_nodes = 0;
+
+        uint64_t tt_probes = 0;
+        uint64_t tt_hits = 0;
+        uint64_t tt_cutoffs = 0;
+
+        uint64_t beta_cutoffs = 0;
+        std::array<uint64_t, CUTOFF_BUCKETS> cutoff_index{};
+
+        uint64_t null_attempts = 0;
+        uint64_t null_cutoffs = 0;
+
+        uint64_t lmr_searches = 0;
+        uint64_t lmr_researches = 0;
+
+        uint64_t singular_searches = 0;
+        uint64_t singular_extensions = 0;
+
+        inline void clear() {
+            *this = Counters{};
+        }
+
+        inline Counters& operator+=(const Counters& other) {
+            search_nodes += other.search_nodes;
+            qsearch_nodes += other.qsearch_nodes;
+            tt_probes += other.tt_probes;
+            tt_hits += other.tt_hits;
+            tt_cutoffs += other.tt_cutoffs;
+            beta_cutoffs += other.beta_cutoffs;
+            for (size_t i = 0; i < CUTOFF_BUCKETS; i++) cutoff_index[i] += other.cutoff_index[i];
+            null_attempts += other.null_attempts;
+            null_cutoffs += other.null_cutoffs;
+            lmr_searches += other.lmr_searches;
+            lmr_researches += other.lmr_researches;
+            singular_searches += other.singular_searches;
+            singular_extensions += other.singular_extensions;
+            return *this;
+        }
+
+        inline void add_cutoff(size_t move_idx) {
+            beta_cutoffs++;
+            cutoff_index[std::min(move_idx, CUTOFF_BUCKETS - 1)]++;
+        }
+
+        void print(bool json) const {
+            auto ratio = [](uint64_t num, uint64_t den) {
+                return den ? static_cast<double>(num) / static_cast<double>(den) : 0.0;
+            };
+
+            const uint64_t total_nodes = search_nodes + qsearch_nodes;
+
+            if (json) {
+                std::cout << "{\"search_nodes\":" << search_nodes
+                    << ",\"qsearch_nodes\":" << qsearch_nodes
+                    << ",\"qsearch_share\":" << ratio(qsearch_nodes, total_nodes)
+                    << ",\"tt\":{\"probes\":" << tt_probes << ",\"hits\":" << tt_hits << ",\"cutoffs\":" << tt_cutoffs << "}"
+                    << ",\"beta_cutoffs\":" << beta_cutoffs
+                    << ",\"first_move_cutoff_rate\":" << ratio(cutoff_index[0], beta_cutoffs)
+                    << ",\"cutoff_index\":[";
+                for (size_t i = 0; i < CUTOFF_BUCKETS; i++) {
+                    std::cout << (i ? "," : "") << cutoff_index[i];
+                }
+                std::cout << "]"
+                    << ",\"null_move\":{\"attempts\":" << null_attempts << ",\"cutoffs\":" << null_cutoffs << "}"
+                    << ",\"lmr\":{\"searches\":" << lmr_searches << ",\"researches\":" << lmr_researches << "}"
+                    << ",\"singular\":{\"searches\":" << singular_searches << ",\"extensions\":" << singular_extensions << "}"
+                    << "}" << std::endl;
+                return;
+            }
+
+            std::cout << std::fixed << std::setprecision(2);
+            std::cout << "nodes        " << search_nodes << " search, " << qsearch_nodes << " qsearch (" << 100 * ratio(qsearch_nodes, total_nodes) << "% qsearch)\n";
+            std::cout << "tt           " << tt_probes << " probes, " << 100 * ratio(tt_hits, tt_probes) << "% hits, " << 100 * ratio(tt_cutoffs, tt_probes) << "% cutoffs\n";
+            std::cout << "cutoffs      " << beta_cutoffs << " total, " << 100 * ratio(cutoff_index[0], beta_cutoffs) << "% on first move\n";
+            std::cout << "cutoff index";
+            for (size_t i = 0; i < CUTOFF_BUCKETS; i++) {
+                std::cout << " " << i << (i == CUTOFF_BUCKETS - 1 ? "+:" : ":") << 100 * ratio(cutoff_index[i], beta_cutoffs) << "%";
+            }
+            std::cout << "\n";
+            std::cout << "null move    " << null_attempts << " attempts, " << 100 * ratio(null_cutoffs, null_attempts) << "% cutoffs\n";
+            std::cout << "lmr          " << lmr_searches << " reduced, " << 100 * ratio(lmr_researches, lmr_searches) << "% re-searched\n";
+            std::cout << "singular     " << singular_searches << " verifications, " << 100 * ratio(singular_extensions, singular_searches) << "% extended" << std::endl;
+            std::cout << std::defaultfloat << std::setprecision(6);
+        }
+    };
+
+    inline thread_local Counters counters{};
+}
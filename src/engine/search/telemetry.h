@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <iostream>
+#include <optional>
+#include <string>
+
+namespace episteme::telemetry {
+    // Bucket i holds values in [2^(i-1), 2^i) microseconds, bucket 0 holds zero
+    class Histogram {
+        public:
+            static constexpr size_t BUCKETS = 24;
+
+            inline void add(int64_t us) {
+                const uint64_t value = static_cast<uint64_t>(std::max<int64_t>(us, 0));
+                counts[std::min<size_t>(std::bit_width(value), BUCKETS - 1)]++;
+            }
+
+            void print(const char* name) const {
+                std::cout << "info string time " << name;
+                for (size_t i = 0; i < BUCKETS; i++) {
+                    if (!counts[i]) continue;
+                    std::cout << " <" << (i == BUCKETS - 1 ? "inf" : std::to_string(uint64_t(1) << i)) << "us:" << counts[i];
+                }
+                std::cout << "\n";
+            }
+
+        private:
+            std::array<uint64_t, BUCKETS> counts{};
+    };
+
+    struct Go {
+        int64_t soft_us = 0;
+        int64_t hard_us = 0;
+        int64_t elapsed_us = 0;
+        // Time from the deadline firing to bestmove, when the search was cut off by it
+        std::optional<int64_t> stop_latency_us;
+    };
+
+    class Session {
+        public:
+            inline void record(const Go& go) {
+                searches++;
+                if (!go.hard_us) return;
+
+                timed++;
+                usage[std::min<size_t>(10 * go.elapsed_us / go.hard_us, USAGE_BUCKETS - 1)]++;
+
+                if (go.elapsed_us > go.hard_us) {
+                    over_hard++;
+                    max_overshoot_us = std::max(max_overshoot_us, go.elapsed_us - go.hard_us);
+                    overshoot.add(go.elapsed_us - go.hard_us);
+                }
+
+                if (go.elapsed_us > go.soft_us) over_soft++;
+                if (go.stop_latency_us) latency.add(*go.stop_latency_us);
+            }
+
+            [[nodiscard]] inline bool empty() const {
+                return timed == 0;
+            }
+
+            void print() const {
+                std::cout << "info string time searches " << searches << " timed " << timed
+                    << " over_soft " << over_soft << " over_hard " << over_hard
+                    << " max_overshoot " << max_overshoot_us << "us\n";
+
+                std::cout << "info string time usage";
+                for (size_t i = 0; i < USAGE_BUCKETS; i++) {
+                    if (!usage[i]) continue;
+                    if (i == USAGE_BUCKETS - 1) std::cout << " >=100%:" << usage[i];
+                    else std::cout << " <" << 10 * (i + 1) << "%:" << usage[i];
+                }
+                std::cout << "\n";
+
+                overshoot.print("overshoot");
+                latency.print("stop_latency");
+                std::cout << std::flush;
+            }
+
+        private:
+            // Elapsed time as a share of the hard budget, in tenths, with a final bucket for overruns
+            static constexpr size_t USAGE_BUCKETS = 11;
+
+            uint64_t searches = 0;
+            uint64_t timed = 0;
+            uint64_t over_soft = 0;
+            uint64_t over_hard = 0;
+            int64_t max_overshoot_us = 0;
+
+            std::array<uint64_t, USAGE_BUCKETS> usage{};
+            Histogram overshoot;
+            Histogram latency;
+    };
+}
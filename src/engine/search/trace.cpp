@@ -0,0 +1,165 @@
+#include "trace.h"
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <algorithm>
+
+namespace episteme::trace {
+    Writer::~Writer() {
+        close();
+    }
+
+    bool Writer::open(const std::string& path, uint32_t size) {
+        close();
+
+        uint64_t capacity = std::max<uint64_t>((static_cast<uint64_t>(size) * 1024 * 1024) / sizeof(Record), 1);
+        size_t file_size = sizeof(Header) + capacity * sizeof(Record);
+
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+
+        if (ftruncate(fd, file_size) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void* mapping = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) return false;
+
+        mapped_size = file_size;
+        header = static_cast<Header*>(mapping);
+        records = reinterpret_cast<Record*>(header + 1);
+        next = 0;
+
+        *header = {.magic = MAGIC, .capacity = capacity, .count = 0};
+        return true;
+    }
+
+    void Writer::close() {
+        if (!header) return;
+
+        munmap(header, mapped_size);
+        header = nullptr;
+        records = nullptr;
+        mapped_size = 0;
+    }
+
+    void summarize(const std::string& path) {
+        constexpr std::array<const char*, 12> REASON_NAMES = {
+            "none", "stopped", "draw", "tt", "static", "null", "singular", "standpat", "beta", "faillow", "exact", "nomoves"
+        };
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cout << "could not open " << path << std::endl;
+            return;
+        }
+
+        off_t file_size = lseek(fd, 0, SEEK_END);
+        if (file_size < static_cast<off_t>(sizeof(Header))) {
+            ::close(fd);
+            std::cout << "invalid trace file " << path << std::endl;
+            return;
+        }
+
+        void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            std::cout << "could not map " << path << std::endl;
+            return;
+        }
+
+        const Header header = *static_cast<const Header*>(mapping);
+        const Record* records = reinterpret_cast<const Record*>(static_cast<const Header*>(mapping) + 1);
+
+        const uint64_t max_capacity = (static_cast<uint64_t>(file_size) - sizeof(Header)) / sizeof(Record);
+        if (header.magic != MAGIC || header.capacity == 0 || header.capacity > max_capacity) {
+            munmap(mapping, file_size);
+            std::cout << "invalid trace file " << path << std::endl;
+            return;
+        }
+
+        struct RootStats {
+            uint16_t move;
+            uint64_t nodes = 0;
+            uint64_t researches = 0;
+        };
+
+        const bool wrapped = header.count > header.capacity;
+        const uint64_t num_records = wrapped ? header.capacity : header.count;
+        const uint64_t first = wrapped ? header.count % header.capacity : 0;
+
+        std::array<uint64_t, 4> kind_counts{};
+        uint64_t invalid_records = 0;
+        std::array<uint64_t, REASON_NAMES.size()> reason_counts{};
+        std::array<uint64_t, 256> research_plies{};
+
+        std::vector<RootStats> root_stats;
+        std::unordered_map<uint16_t, size_t> root_index;
+        uint64_t pending_nodes = 0;
+        uint64_t pending_researches = 0;
+
+        for (uint64_t i = 0; i < num_records; i++) {
+            const Record& record = records[(first + i) % header.capacity];
+            if (static_cast<size_t>(record.kind) >= kind_counts.size()) {
+                invalid_records++;
+                continue;
+            }
+            kind_counts[static_cast<size_t>(record.kind)]++;
+
+            if (record.kind == Kind::LMRResearch || record.kind == Kind::PVSResearch) {
+                research_plies[record.ply]++;
+                pending_researches++;
+                continue;
+            }
+
+            reason_counts[std::min<size_t>(static_cast<size_t>(record.reason), REASON_NAMES.size() - 1)]++;
+            pending_nodes++;
+
+            if (record.ply == 1) {
+                auto [it, inserted] = root_index.try_emplace(record.move, root_stats.size());
+                if (inserted) root_stats.push_back({.move = record.move});
+
+                root_stats[it->second].nodes += pending_nodes;
+                root_stats[it->second].researches += pending_researches;
+                pending_nodes = 0;
+                pending_researches = 0;
+            }
+        }
+
+        munmap(mapping, file_size);
+
+        std::cout << "trace " << path << ": " << num_records << " records, capacity " << header.capacity << (wrapped ? ", wrapped" : "") << "\n";
+        std::cout << "nodes " << kind_counts[0] << " search " << kind_counts[1] << " qsearch\n";
+        std::cout << "researches " << kind_counts[2] << " lmr " << kind_counts[3] << " pvs\n";
+        if (invalid_records) std::cout << "skipped " << invalid_records << " records with an invalid kind\n";
+
+        std::cout << "exits";
+        for (size_t i = 0; i < REASON_NAMES.size(); i++) {
+            if (reason_counts[i]) std::cout << " " << REASON_NAMES[i] << ":" << reason_counts[i];
+        }
+        std::cout << "\n";
+
+        std::cout << "research plies";
+        for (size_t ply = 0; ply < research_plies.size(); ply++) {
+            if (research_plies[ply]) std::cout << " " << ply << ":" << research_plies[ply];
+        }
+        std::cout << "\n";
+
+        std::sort(root_stats.begin(), root_stats.end(), [](const RootStats& a, const RootStats& b) {
+            return a.nodes > b.nodes;
+        });
+
+        for (const RootStats& stats : root_stats) {
+            std::cout << "root " << Move(stats.move).to_string() << " nodes " << stats.nodes << " researches " << stats.researches << "\n";
+        }
+        std::cout << std::flush;
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "../chess/move.h"
+
+#include <cstdint>
+#include <string>
+
+namespace episteme::trace {
+#ifdef EPISTEME_TRACE
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    constexpr uint64_t MAGIC = 0x3145434152545045; // "EPTRACE1"
+
+    enum class Kind : uint8_t {
+        Search, QSearch, LMRResearch, PVSResearch
+    };
+
+    enum class Reason : uint8_t {
+        None, Stopped, Draw, TTCutoff, StaticPrune, NullCutoff, SingularCutoff, StandPat, BetaCutoff, FailLow, Exact, NoMoves
+    };
+
+    // Node records are written on exit, so the file is a post-order walk of the tree
+    struct Record {
+        int32_t alpha;
+        int32_t beta;
+        int32_t score;
+        uint16_t move;
+        uint8_t ply;
+        int8_t depth;
+        Kind kind;
+        Reason reason;
+    };
+
+    struct Header {
+        uint64_t magic;
+        uint64_t capacity;
+        uint64_t count;
+    };
+
+    class Writer {
+        public:
+            Writer() = default;
+            Writer(const Writer&) = delete;
+            Writer& operator=(const Writer&) = delete;
+            ~Writer();
+
+            bool open(const std::string& path, uint32_t size);
+            void close();
+
+            [[nodiscard]] inline bool active() const {
+                return records != nullptr;
+            }
+
+            inline void write(const Record& record) {
+                records[next++] = record;
+                if (next == header->capacity) next = 0;
+                header->count++;
+            }
+
+            inline void write(Kind kind, Reason reason, Move move, int32_t ply, int32_t depth, int32_t alpha, int32_t beta, int32_t score) {
+                write({
+                    .alpha = alpha,
+                    .beta = beta,
+                    .score = score,
+                    .move = move.data(),
+                    .ply = static_cast<uint8_t>(ply),
+                    .depth = static_cast<int8_t>(depth),
+                    .kind = kind,
+                    .reason = reason
+                });
+            }
+
+        private:
+            Header* header = nullptr;
+            Record* records = nullptr;
+            uint64_t next = 0;
+            size_t mapped_size = 0;
+    };
+
+    void summarize(const std::string& path);
+}
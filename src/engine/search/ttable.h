@@ -51,6 +51,14 @@ namespace episteme::tt {
                 uint64_t index = table_index(tt_entry.hash);
                 ttable[index] = tt_entry;
             }
+
+            [[nodiscard]] inline const void* data() const {
+                return ttable.data();
+            }
+
+            [[nodiscard]] inline size_t bytes() const {
+                return ttable.size() * sizeof(Entry);
+            }
         private:
             std::vector<Entry> ttable;
     };
@@ -0,0 +1,167 @@
+#include "session.h"
+#include "uci.h"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace episteme::uci {
+    using namespace std::chrono;
+
+    int Recorder::TeeBuffer::overflow(int c) {
+        if (c == traits_type::eof()) return traits_type::not_eof(c);
+
+        if (c == '\n') {
+            recorder.write('<', line);
+            line.clear();
+        } else {
+            line += static_cast<char>(c);
+        }
+
+        return target->sputc(static_cast<char>(c));
+    }
+
+    int Recorder::TeeBuffer::sync() {
+        return target->pubsync();
+    }
+
+    Recorder::~Recorder() {
+        if (original) std::cout.rdbuf(original);
+    }
+
+    bool Recorder::open(const std::string& path) {
+        file.open(path, std::ios::trunc);
+        if (!file) return false;
+
+        start = steady_clock::now();
+        original = std::cout.rdbuf();
+        tee.emplace(original, *this);
+        std::cout.rdbuf(&*tee);
+
+        return true;
+    }
+
+    void Recorder::input(const std::string& line) {
+        if (file.is_open()) write('>', line);
+    }
+
+    // Flushed per line, so the session survives the engine being killed mid-game
+    void Recorder::write(char direction, const std::string& line) {
+        file << duration_cast<microseconds>(steady_clock::now() - start).count() << " " << direction << " " << line << std::endl;
+    }
+
+    namespace {
+        struct Event {
+            int64_t time;
+            char direction;
+            std::string text;
+        };
+
+        std::vector<Event> load_session(const std::string& path) {
+            std::vector<Event> events;
+            std::ifstream file(path);
+            std::string line;
+
+            while (std::getline(file, line)) {
+                std::istringstream iss(line);
+                Event event;
+                if (!(iss >> event.time >> event.direction)) continue;
+
+                iss.get();
+                std::getline(iss, event.text);
+                events.push_back(std::move(event));
+            }
+
+            return events;
+        }
+
+        // Drops every limit so the search is bounded by the node count alone
+        std::string fixed_node_go(const std::string& go, uint64_t nodes) {
+            std::istringstream iss(go);
+            std::string token, out = "go";
+
+            iss >> token;
+            while (iss >> token) {
+                if (token == "wtime" || token == "btime" || token == "winc" || token == "binc" || token == "movestogo"
+                    || token == "movetime" || token == "depth" || token == "nodes") {
+                    iss >> token;
+                }
+                else if (token != "infinite" && token != "ponder") out += " " + token;
+            }
+
+            return out + " nodes " + std::to_string(nodes);
+        }
+    }
+
+    void replay_session(const std::string& path, const ReplayOptions& options, search::Config& cfg, search::Engine& engine) {
+        std::vector<Event> events = load_session(path);
+        if (events.empty()) {
+            std::cout << "could not read session " << path << std::endl;
+            return;
+        }
+
+        const auto start = steady_clock::now();
+        const int64_t first_time = events.front().time;
+
+        int64_t total_recorded = 0;
+        int64_t total_replayed = 0;
+        size_t num_go = 0;
+
+        // The nodes override rewrites cfg.params, which outlives the replay, so put the caller's limits back afterwards
+        const search::Parameters saved_params = cfg.params;
+
+        for (size_t i = 0; i < events.size(); i++) {
+            const Event& event = events[i];
+            if (event.direction != '>') continue;
+
+            const std::string keyword = event.text.substr(0, event.text.find(' '));
+            if (keyword == "quit") break;
+            if (keyword == "replay") continue;
+
+            if (!options.fast) std::this_thread::sleep_until(start + microseconds(event.time - first_time));
+
+            std::string command = event.text;
+            if (keyword == "go" && options.nodes && command.find("perft") == std::string::npos) {
+                // cfg.params outlives a go, so clear time limits carried over from earlier commands
+                cfg.params.time = {};
+                cfg.params.inc = {};
+                cfg.params.depth = search::Parameters{}.depth;
+                command = fixed_node_go(command, *options.nodes);
+            }
+
+            const auto command_start = steady_clock::now();
+            parse(command, cfg, engine);
+            const int64_t replayed = duration_cast<microseconds>(steady_clock::now() - command_start).count();
+
+            if (keyword != "go") continue;
+
+            // Only output before the next command belongs to this go; go perft or an aborted search has no bestmove
+            std::optional<int64_t> recorded;
+            for (size_t j = i + 1; j < events.size() && events[j].direction != '>'; j++) {
+                if (events[j].direction == '<' && events[j].text.starts_with("bestmove")) {
+                    recorded = events[j].time - event.time;
+                    break;
+                }
+            }
+
+            num_go++;
+            total_replayed += replayed;
+            if (recorded) total_recorded += *recorded;
+
+            std::cout << "info replay go " << num_go << " replayed " << replayed << "us";
+            if (recorded) {
+                std::cout << " recorded " << *recorded << "us change " << std::fixed << std::setprecision(1) << std::showpos
+                    << (*recorded > 0 ? 100.0 * (replayed - *recorded) / *recorded : 0.0) << std::noshowpos << "%" << std::defaultfloat;
+            } else {
+                std::cout << " no recorded bestmove";
+            }
+            std::cout << std::endl;
+        }
+
+        cfg.params = saved_params;
+
+        std::cout << "info replay " << num_go << " go commands, recorded " << total_recorded << "us, replayed " << total_replayed << "us" << std::endl;
+    }
+}
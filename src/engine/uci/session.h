@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../search/search.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <streambuf>
+#include <string>
+
+namespace episteme::uci {
+    // Session files hold one line per event: microseconds since the start, '>' for input or '<' for output, then the text
+    class Recorder {
+        public:
+            Recorder() = default;
+            Recorder(const Recorder&) = delete;
+            Recorder& operator=(const Recorder&) = delete;
+            ~Recorder();
+
+            bool open(const std::string& path);
+            void input(const std::string& line);
+
+        private:
+            // Passes output through to the real stdout and copies whole lines into the session file
+            class TeeBuffer : public std::streambuf {
+                public:
+                    TeeBuffer(std::streambuf* target, Recorder& recorder) : target(target), recorder(recorder) {};
+
+                protected:
+                    int overflow(int c) override;
+                    int sync() override;
+
+                private:
+                    std::streambuf* target;
+                    Recorder& recorder;
+                    std::string line;
+            };
+
+            void write(char direction, const std::string& line);
+
+            std::ofstream file;
+            std::chrono::steady_clock::time_point start;
+            std::optional<TeeBuffer> tee;
+            std::streambuf* original = nullptr;
+    };
+
+    struct ReplayOptions {
+        bool fast = false;
+        std::optional<uint64_t> nodes;
+    };
+
+    void replay_session(const std::string& path, const ReplayOptions& options, search::Config& cfg, search::Engine& engine);
+}
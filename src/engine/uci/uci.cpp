@@ -1,4 +1,5 @@
 #include "uci.h"
+#include "session.h"
 
 namespace episteme::uci {
 
@@ -46,17 +47,21 @@ namespace episteme::uci {
 
         } else if (token == "fen") {    
             std::string fen;
-            for (int i = 0; i < 6 && iss >> token; ++i) {
+            while (iss >> token && token != "moves") {
                 if (!fen.empty()) fen += " ";
                 fen += token;
             }
-            position.from_FEN(fen);
+
+            if (FENError error = position.from_FEN(fen); error != FENError::None) {
+                std::cout << "invalid fen: " << fen_error_string(error) << "\n";
+                return;
+            }
 
         } else {
             std::cout << "invalid command\n";
         }
 
-        if (iss >> token && token == "moves") {
+        if (token == "moves" || (iss >> token && token == "moves")) {
             while (iss >> token) {
                 position.make_move(from_UCI(position, token));
             }
@@ -69,22 +74,44 @@ namespace episteme::uci {
         std::istringstream iss(args);
         std::string token;
 
+        std::optional<std::string> trace_path;
+        uint32_t trace_size = 64;
+
         while (iss >> token) {
-            if (token == "wtime" && iss >> token) cfg.params.time[0] = std::stoi(token);
+            if (token == "perft" && iss >> token) {
+                split_perft(cfg.position, std::stoi(token), cfg.num_threads);
+                return;
+            }
+            else if (token == "wtime" && iss >> token) cfg.params.time[0] = std::stoi(token);
             else if (token == "btime" && iss >> token) cfg.params.time[1] = std::stoi(token);
             else if (token == "winc" && iss >> token) cfg.params.inc[0] = std::stoi(token);
             else if (token == "binc" && iss >> token) cfg.params.inc[1] = std::stoi(token);
             else if (token == "depth" && iss >> token) cfg.params.depth = std::stoi(token);
             else if (token == "nodes" && iss >> token) cfg.params.nodes = std::stoi(token);
+            else if (token == "trace" && iss >> token) trace_path = token;
+            else if (token == "tracesize" && iss >> token) trace_size = std::stoi(token);
             else {
                 std::cout << "invalid command\n"; 
                 break;
             }
         }
 
+        if (trace_path) {
+            if constexpr (!trace::ENABLED) {
+                std::cout << "info string trace disabled, rebuild with EPISTEME_TRACE" << std::endl;
+                trace_path.reset();
+            }
+            else if (!engine.start_trace(*trace_path, trace_size)) {
+                std::cout << "info string could not open trace file " << *trace_path << std::endl;
+                trace_path.reset();
+            }
+        }
+
         engine.reset_go();
         engine.update_params(cfg.params);
         engine.run(cfg.position);
+
+        if (trace_path) engine.stop_trace();
     }
 
     auto ucinewgame(search::Config& cfg, search::Engine& engine) {
@@ -92,24 +119,187 @@ namespace episteme::uci {
         cfg.position = {};
         engine.reset_game();
     }
+
+    auto quit(search::Engine& engine) {
+        if (!engine.time_telemetry().empty()) engine.time_telemetry().print();
+        std::exit(0);
+    }
+
+    auto timestats(search::Engine& engine) {
+        engine.time_telemetry().print();
+    }
     
     auto eval(search::Config& cfg, search::Engine& engine) {
         engine.eval(cfg.position);
     }
     
     auto bench(const std::string& args, search::Config& cfg) {
-        int depth = (args.empty()) ? 10 : std::stoi(args);
-        if (!cfg.hash_size) cfg.hash_size = 32;
+        std::istringstream iss(args);
+        std::string token;
+
+        search::BenchOptions options;
+        if (cfg.hash_size) options.hash_size = cfg.hash_size;
 
-        search::Engine engine(cfg);
-        engine.bench(depth);
+        // bench compare <history> and bench compare net <file> take the depth as an option instead
+        std::string compare_path, network_path, baseline;
+        bool compare = false;
+        std::optional<int32_t> repetitions;
+
+        if (iss >> token) {
+            if (token == "compare") {
+                compare = true;
+                if (!(iss >> token) || (token == "net" && !(iss >> network_path))) {
+                    std::cout << "invalid command\n";
+                    return;
+                }
+                if (network_path.empty()) compare_path = token;
+            }
+            else options.depth = std::stoi(token);
+        }
+
+        while (iss >> token) {
+            if (token == "depth" && iss >> token) options.depth = std::stoi(token);
+            else if (token == "history" && iss >> token) options.history_path = token;
+            else if (token == "commit" && iss >> token) options.commit = token;
+            else if (token == "baseline" && iss >> token) baseline = token;
+            else if (token == "threads" && iss >> token) options.num_threads = std::stoi(token);
+            else if (token == "hash" && iss >> token) options.hash_size = std::stoi(token);
+            else if (token == "warmup" && iss >> token) options.warmup = std::stoi(token);
+            else if (token == "reps" && iss >> token) repetitions = std::stoi(token);
+            else if (token == "pin" && iss >> token) options.pin_cpu = std::stoi(token);
+            else if (token == "json") options.json = true;
+            else if (token == "perf") options.perf = true;
+            else if (token == "allocs") options.allocs = true;
+            else {
+                std::cout << "invalid command\n";
+                return;
+            }
+        }
+
+        // A comparison needs a spread on both sides, and history entries become later baselines, so both default to several repetitions
+        options.repetitions = repetitions.value_or((compare || !options.history_path.empty()) ? 6 : 1);
+
+        if (!network_path.empty()) search::bench_networks(options, network_path);
+        else if (compare) search::bench_compare(options, compare_path, baseline);
+        else search::bench(options);
     }
 
     auto perft(const std::string& args, search::Config& cfg) {
-        int depth = (args.empty()) ? 6 : std::stoi(args);
+        std::istringstream iss(args);
+        std::string token;
+
+        int depth = (iss >> token) ? std::stoi(token) : 6;
+        std::optional<uint16_t> num_threads;
+        std::optional<uint32_t> hash_size;
+
+        while (iss >> token) {
+            if (token == "threads" && iss >> token) num_threads = std::stoi(token);
+            else if (token == "hash" && iss >> token) hash_size = std::stoi(token);
+            else {
+                std::cout << "invalid command\n";
+                return;
+            }
+        }
+
         Position& position = cfg.position;
 
-        time_perft(position, depth);
+        if (num_threads || hash_size) split_perft(position, depth, num_threads.value_or(1), hash_size.value_or(0));
+        else time_perft(position, depth);
+    }
+
+    auto perftsuite(const std::string& args) {
+        std::istringstream iss(args);
+        std::string path, token;
+
+        if (!(iss >> path)) {
+            std::cout << "invalid command\n";
+            return;
+        }
+
+        uint16_t num_threads = 1;
+
+        while (iss >> token) {
+            if (token == "threads" && iss >> token) num_threads = std::stoi(token);
+            else {
+                std::cout << "invalid command\n";
+                return;
+            }
+        }
+
+        perft_suite(path, num_threads);
+    }
+
+    auto sliderbench(const std::string& args, search::Config& cfg) {
+        int depth = (args.empty()) ? 5 : std::stoi(args);
+        Position& position = cfg.position;
+
+        search::bench_sliders(position, depth);
+    }
+
+    auto tracereport(const std::string& args) {
+        if (args.empty()) {
+            std::cout << "invalid command\n";
+            return;
+        }
+
+        trace::summarize(args);
+    }
+
+    auto stats(const std::string& args) {
+        if constexpr (!stats::ENABLED) {
+            std::cout << "info string stats disabled, rebuild with EPISTEME_STATS" << std::endl;
+            return;
+        }
+
+        if (args == "json") stats::counters.print(true);
+        else if (args.empty()) stats::counters.print(false);
+        else std::cout << "invalid command\n";
+    }
+
+    auto fenbench(const std::string& args) {
+        int rounds = (args.empty()) ? 20000 : std::stoi(args);
+        search::bench_fen(rounds);
+    }
+
+    auto memory(const std::string& args, search::Config& cfg, search::Engine& engine) {
+        std::istringstream iss(args);
+        std::string token;
+
+        uint16_t num_threads = cfg.num_threads;
+        uint32_t hash_size = cfg.hash_size;
+
+        while (iss >> token) {
+            if (token == "threads" && iss >> token) num_threads = std::stoi(token);
+            else if (token == "hash" && iss >> token) hash_size = std::stoi(token);
+            else {
+                std::cout << "invalid command\n";
+                return;
+            }
+        }
+
+        engine.memory(num_threads, hash_size);
+    }
+
+    auto replay(const std::string& args, search::Config& cfg, search::Engine& engine) {
+        std::istringstream iss(args);
+        std::string path, token;
+
+        if (!(iss >> path)) {
+            std::cout << "invalid command\n";
+            return;
+        }
+
+        ReplayOptions options;
+        while (iss >> token) {
+            if (token == "fast") options.fast = true;
+            else if (token == "nodes" && iss >> token) options.nodes = std::stoull(token);
+            else {
+                std::cout << "invalid command\n";
+                return;
+            }
+        }
+
+        replay_session(path, options, cfg, engine);
     }
 
     auto datagen(const std::string& args) {
@@ -130,7 +320,8 @@ namespace episteme::uci {
             }
         }
 
-        datagen::run(params);
+        // A failed run leaves a truncated file behind, so scripts driving datagen need to see the failure
+        if (!datagen::run(params)) std::exit(1);
     }
 
     int parse(const std::string& cmd, search::Config& cfg, search::Engine& engine) {
@@ -142,7 +333,7 @@ namespace episteme::uci {
         else if (keyword == "position") position(cmd.substr(cmd.find(" ")+1), cfg);
         else if (keyword == "go") go(cmd.substr(cmd.find(" ")+1), cfg, engine);
         else if (keyword == "ucinewgame") ucinewgame(cfg, engine);
-        else if (keyword == "quit") std::exit(0);
+        else if (keyword == "quit") quit(engine);
 
         else if (keyword == "bench") {
             size_t space = cmd.find(' ');
@@ -154,8 +345,44 @@ namespace episteme::uci {
             std::string arg = (space != std::string::npos) ? cmd.substr(space+1) : "";
             perft(arg, cfg);
         }
+        else if (keyword == "perftsuite") {
+            size_t space = cmd.find(' ');
+            std::string arg = (space != std::string::npos) ? cmd.substr(space+1) : "";
+            perftsuite(arg);
+        }
+        else if (keyword == "tracereport") {
+            size_t space = cmd.find(' ');
+            std::string arg = (space != std::string::npos) ? cmd.substr(space+1) : "";
+            tracereport(arg);
+        }
+        else if (keyword == "stats") {
+            size_t space = cmd.find(' ');
+            std::string arg = (space != std::string::npos) ? cmd.substr(space+1) : "";
+            stats(arg);
+        }
+        else if (keyword == "fenbench") {
+            size_t space = cmd.find(' ');
+            std::string arg = (space != std::string::npos) ? cmd.substr(space+1) : "";
+            fenbench(arg);
+        }
+        else if (keyword == "replay") {
+            size_t space = cmd.find(' ');
+            std::string arg = (space != std::string::npos) ? cmd.substr(space+1) : "";
+            replay(arg, cfg, engine);
+        }
+        else if (keyword == "memory") {
+            size_t space = cmd.find(' ');
+            std::string arg = (space != std::string::npos) ? cmd.substr(space+1) : "";
+            memory(arg, cfg, engine);
+        }
+        else if (keyword == "sliderbench") {
+            size_t space = cmd.find(' ');
+            std::string arg = (space != std::string::npos) ? cmd.substr(space+1) : "";
+            sliderbench(arg, cfg);
+        }
 
         else if (keyword == "eval") eval(cfg, engine);
+        else if (keyword == "timestats") timestats(engine);
         else if (keyword == "datagen") datagen(cmd.substr(cmd.find(" ")+1));
 
         else std::cout << "invalid command\n";
@@ -19,8 +19,17 @@ namespace episteme::uci {
     auto position(const std::string& args, search::Config& cfg);
     auto go(const std::string& args, search::Config& cfg, search::Engine& engine);
     auto ucinewgame(search::Config& cfg, search::Engine& engine);
+    auto quit(search::Engine& engine);
+    auto timestats(search::Engine& engine);
     auto eval(search::Config& cfg, search::Engine& engine);
     auto bench(const std::string& args, search::Config& cfg);
     auto perft(const std::string& args, search::Config& cfg);
+    auto perftsuite(const std::string& args);
+    auto sliderbench(const std::string& args, search::Config& cfg);
+    auto tracereport(const std::string& args);
+    auto stats(const std::string& args);
+    auto fenbench(const std::string& args);
+    auto memory(const std::string& args, search::Config& cfg, search::Engine& engine);
+    auto replay(const std::string& args, search::Config& cfg, search::Engine& engine);
     auto datagen(const std::string& args);
 }
\ No newline at end of file
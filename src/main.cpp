@@ -3,29 +3,45 @@
 #include "engine/search/search.h"
 #include "engine/search/bench.h"
 #include "engine/uci/uci.h"
+#include "engine/uci/session.h"
 
 #include <string>
 
 using namespace episteme;
 
 int main(int argc, char *argv[]) {
-    zobrist::init();
-    search::init_lmr_table();
+    if (!check_slider_backend()) {
+        std::cout << "this build uses pext slider attacks, but the cpu has no BMI2" << std::endl;
+        return 1;
+    }
 
     search::Config cfg;
     search::Engine engine(cfg);
 
-    if (argc > 1) {
+    // "record <file>" keeps the session, input and output, for a later replay
+    uci::Recorder recorder;
+    int first_arg = 1;
+    if (argc > 2 && std::string(argv[1]) == "record") {
+        if (!recorder.open(argv[2])) {
+            std::cout << "could not open " << argv[2] << std::endl;
+            return 1;
+        }
+        first_arg = 3;
+    }
+
+    if (argc > first_arg) {
         std::string cmd;
-        for (int i = 1; i < argc; ++i) {
+        for (int i = first_arg; i < argc; ++i) {
             cmd += argv[i];
             if (i < argc - 1) cmd += ' ';
         }
+        recorder.input(cmd);
         uci::parse(cmd, cfg, engine);
 
     } else {
         std::string line;
         while (std::getline(std::cin, line)) {
+            recorder.input(line);
             uci::parse(line, cfg, engine);    
         }    
     }
@@ -0,0 +1,324 @@
+#include "../engine/chess/movegen.h"
+#include "../engine/evaluation/evaluate.h"
+#include "../engine/search/ttable.h"
+#include "../engine/search/bench.h"
+#include "../utils/perf.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace episteme;
+using namespace std::chrono;
+
+namespace {
+    constexpr int SAMPLES = 7;
+    constexpr int64_t TARGET_SAMPLE_NS = 50'000'000;
+
+    struct Corpus {
+        std::vector<Position> positions;
+        std::vector<MoveList> moves;
+        std::vector<nn::Accumulator> accumulators;
+    };
+
+    struct Result {
+        std::string name;
+        double ns_per_op;
+        uint64_t ops;
+        perf::Sample perf;
+        double min_ns = 0;
+        double max_ns = 0;
+    };
+
+    // Median and the spread of the samples around it
+    struct Timing {
+        double median;
+        double min;
+        double max;
+    };
+
+    uint64_t sink = 0;
+
+    // fn runs one pass over the corpus and returns its op count; passes are repeated to fill a sample
+    Result measure(const std::string& name, const std::function<uint64_t()>& fn, perf::Counters* counters) {
+        auto start = steady_clock::now();
+        uint64_t ops_per_pass = fn();
+        int64_t pass_ns = std::max<int64_t>(duration_cast<nanoseconds>(steady_clock::now() - start).count(), 1);
+
+        const int64_t passes = std::max<int64_t>(TARGET_SAMPLE_NS / pass_ns, 1);
+
+        std::vector<double> samples;
+        perf::Sample perf_total;
+        for (int sample = 0; sample < SAMPLES; sample++) {
+            if (counters) counters->start();
+            start = steady_clock::now();
+            for (int64_t pass = 0; pass < passes; pass++) fn();
+            int64_t elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+            if (counters) perf_total += counters->stop();
+
+            samples.push_back(static_cast<double>(elapsed) / (passes * ops_per_pass));
+        }
+
+        std::sort(samples.begin(), samples.end());
+        return {name, samples[SAMPLES / 2], ops_per_pass * passes, perf_total, samples.front(), samples.back()};
+    }
+
+    Corpus load_corpus() {
+        Corpus corpus;
+
+        for (const std::string& fen : search::fens) {
+            Position position;
+            position.from_FEN(fen);
+
+            MoveList move_list;
+            generate_legal_moves(move_list, position);
+
+            corpus.accumulators.push_back(eval::reset(position));
+            corpus.moves.push_back(move_list);
+            corpus.positions.push_back(std::move(position));
+        }
+
+        return corpus;
+    }
+
+    std::vector<Result> run_all(Corpus& corpus, const std::string& filter, perf::Counters* counters) {
+        std::vector<std::pair<std::string, std::function<uint64_t()>>> benches;
+
+        benches.emplace_back("generate_all_moves", [&]() {
+            MoveList move_list;
+            for (const Position& position : corpus.positions) {
+                move_list.clear();
+                generate_all_moves(move_list, position);
+                sink += move_list.count;
+            }
+            return static_cast<uint64_t>(corpus.positions.size());
+        });
+
+        benches.emplace_back("generate_all_captures", [&]() {
+            MoveList move_list;
+            for (const Position& position : corpus.positions) {
+                move_list.clear();
+                generate_all_captures(move_list, position);
+                sink += move_list.count;
+            }
+            return static_cast<uint64_t>(corpus.positions.size());
+        });
+
+        benches.emplace_back("make_unmake_move", [&]() {
+            uint64_t ops = 0;
+            for (size_t i = 0; i < corpus.positions.size(); i++) {
+                Position& position = corpus.positions[i];
+                for (size_t j = 0; j < corpus.moves[i].count; j++) {
+                    position.make_move(corpus.moves[i].list[j]);
+                    sink += position.zobrist();
+                    position.unmake_move();
+                }
+                ops += corpus.moves[i].count;
+            }
+            return ops;
+        });
+
+        benches.emplace_back("update_accumulator", [&]() {
+            uint64_t ops = 0;
+            for (size_t i = 0; i < corpus.positions.size(); i++) {
+                for (size_t j = 0; j < corpus.moves[i].count; j++) {
+                    nn::Accumulator accum = eval::update(corpus.positions[i], corpus.moves[i].list[j], corpus.accumulators[i]);
+                    sink += accum.white[j % nn::L1_WIDTH];
+                }
+                ops += corpus.moves[i].count;
+            }
+            return ops;
+        });
+
+        benches.emplace_back("reset_accumulator", [&]() {
+            for (const Position& position : corpus.positions) {
+                nn::Accumulator accum = eval::reset(position);
+                sink += accum.black[0];
+            }
+            return static_cast<uint64_t>(corpus.positions.size());
+        });
+
+        benches.emplace_back("l1_forward", [&]() {
+            for (size_t i = 0; i < corpus.positions.size(); i++) {
+                sink += eval::evaluate(corpus.accumulators[i], corpus.positions[i].STM());
+            }
+            return static_cast<uint64_t>(corpus.positions.size());
+        });
+
+        benches.emplace_back("see", [&]() {
+            uint64_t ops = 0;
+            for (size_t i = 0; i < corpus.positions.size(); i++) {
+                for (size_t j = 0; j < corpus.moves[i].count; j++) {
+                    sink += eval::SEE(corpus.positions[i], corpus.moves[i].list[j], 0);
+                }
+                ops += corpus.moves[i].count;
+            }
+            return ops;
+        });
+
+        constexpr size_t NUM_KEYS = 1 << 16;
+        std::vector<uint64_t> keys(NUM_KEYS);
+        std::mt19937_64 gen(42);
+        for (uint64_t& key : keys) key = gen();
+
+        std::vector<std::unique_ptr<tt::Table>> tables;
+
+        for (uint32_t size : {1u, 16u, 256u}) {
+            std::string suffix = "_" + std::to_string(size) + "mb";
+            auto matches = [&](const std::string& name) { return filter.empty() || name.find(filter) != std::string::npos; };
+            if (!matches("tt_add" + suffix) && !matches("tt_probe" + suffix)) continue;
+
+            tables.push_back(std::make_unique<tt::Table>(size));
+            tt::Table& table = *tables.back();
+
+            benches.emplace_back("tt_add" + suffix, [&table, &keys]() {
+                for (uint64_t key : keys) {
+                    table.add({.hash = key, .move = Move(static_cast<uint16_t>(key)), .score = 0, .depth = 1, .node_type = tt::NodeType::PVNode});
+                }
+                return static_cast<uint64_t>(keys.size());
+            });
+
+            benches.emplace_back("tt_probe" + suffix, [&table, &keys]() {
+                for (uint64_t key : keys) {
+                    sink += table.probe(key).score;
+                }
+                return static_cast<uint64_t>(keys.size());
+            });
+        }
+
+        std::vector<Result> results;
+        for (const auto& [name, fn] : benches) {
+            if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+
+            results.push_back(measure(name, fn, counters));
+            const Result& result = results.back();
+            std::cout << std::left << std::setw(24) << result.name << std::right << std::fixed << std::setprecision(2)
+                << std::setw(12) << result.ns_per_op << " ns/op" << std::setw(14) << result.ops << " ops";
+            if (counters) perf::print_rates(std::cout, result.perf, static_cast<double>(result.ops) * SAMPLES, "op");
+            std::cout << std::endl;
+        }
+
+        return results;
+    }
+
+    void save_baseline(const std::string& path, const std::vector<Result>& results) {
+        std::ofstream file(path);
+        for (const Result& result : results) {
+            file << result.name << " " << result.ns_per_op << " " << result.min_ns << " " << result.max_ns << "\n";
+        }
+    }
+
+    bool compare_baseline(const std::string& path, const std::vector<Result>& results, const std::string& filter) {
+        std::ifstream file(path);
+        if (!file) {
+            std::cout << "could not open " << path << std::endl;
+            return false;
+        }
+
+        // Older baselines only stored the median, which then stands in for the whole spread
+        std::map<std::string, Timing> baseline;
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream iss(line);
+            std::string name;
+            Timing timing;
+            if (!(iss >> name >> timing.median)) continue;
+            if (!(iss >> timing.min >> timing.max)) timing.min = timing.max = timing.median;
+            baseline[name] = timing;
+        }
+
+        std::vector<std::string> missing_baseline;
+        std::set<std::string> seen;
+
+        std::cout << "\n" << std::left << std::setw(24) << "benchmark" << std::right << std::setw(12) << "baseline" << std::setw(12) << "current" << std::setw(10) << "change" << "\n";
+        for (const Result& result : results) {
+            auto it = baseline.find(result.name);
+            if (it == baseline.end()) {
+                missing_baseline.push_back(result.name);
+                continue;
+            }
+            seen.insert(result.name);
+
+            // Only a change whose sample ranges don't overlap is told apart from noise
+            const Timing& base = it->second;
+            const char* verdict = (result.min_ns > base.max) ? "  slower" : (result.max_ns < base.min) ? "  faster" : "  within noise";
+
+            double change = 100.0 * (result.ns_per_op - base.median) / base.median;
+            std::cout << std::left << std::setw(24) << result.name << std::right << std::fixed << std::setprecision(2)
+                << std::setw(12) << base.median << std::setw(12) << result.ns_per_op
+                << std::setw(9) << std::showpos << change << std::noshowpos << "%" << verdict << "\n";
+        }
+
+        if (!missing_baseline.empty()) {
+            std::cout << "not in baseline:";
+            for (const std::string& name : missing_baseline) std::cout << " " << name;
+            std::cout << "\n";
+        }
+
+        std::vector<std::string> missing_current;
+        for (const auto& [name, timing] : baseline) {
+            if (!seen.contains(name) && (filter.empty() || name.find(filter) != std::string::npos)) missing_current.push_back(name);
+        }
+
+        if (!missing_current.empty()) {
+            std::cout << "not in this run:";
+            for (const std::string& name : missing_current) std::cout << " " << name;
+            std::cout << "\n";
+        }
+        std::cout << std::flush;
+
+        return true;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (!check_slider_backend()) {
+        std::cout << "this build uses pext slider attacks, but the cpu has no BMI2" << std::endl;
+        return 1;
+    }
+
+    std::string save_path, compare_path, filter;
+    bool use_perf = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "save" && i + 1 < argc) save_path = argv[++i];
+        else if (arg == "compare" && i + 1 < argc) compare_path = argv[++i];
+        else if (arg == "filter" && i + 1 < argc) filter = argv[++i];
+        else if (arg == "perf") use_perf = true;
+        else {
+            std::cout << "usage: episteme-microbench [filter <name>] [save <file>] [compare <file>] [perf]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::optional<perf::Counters> counters;
+    if (use_perf) {
+        counters.emplace();
+        if (!counters->available()) {
+            std::cout << "perf counters unavailable" << std::endl;
+            counters.reset();
+        }
+    }
+
+    Corpus corpus = load_corpus();
+    std::vector<Result> results = run_all(corpus, filter, counters ? &*counters : nullptr);
+
+    if (!save_path.empty()) save_baseline(save_path, results);
+    if (!compare_path.empty() && !compare_baseline(compare_path, results, filter)) return 1;
+
+    std::cout << "checksum " << sink << std::endl;
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "alloc.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace episteme::alloc {
+    namespace {
+        thread_local Counts counts{};
+    }
+
+    Counts thread_counts() {
+        return counts;
+    }
+}
+
+#ifdef EPISTEME_ALLOC_COUNT
+// The array and nothrow forms forward to these by default
+void* operator new(std::size_t size) {
+    episteme::alloc::counts.allocations++;
+    episteme::alloc::counts.bytes += size;
+
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    episteme::alloc::counts.allocations++;
+    episteme::alloc::counts.bytes += size;
+
+    const std::size_t alignment = static_cast<std::size_t>(align);
+    const std::size_t rounded = (std::max<std::size_t>(size, 1) + alignment - 1) & ~(alignment - 1);
+
+    if (void* ptr = std::aligned_alloc(alignment, rounded)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) return;
+    episteme::alloc::counts.deallocations++;
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    if (!ptr) return;
+    episteme::alloc::counts.deallocations++;
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t align) noexcept {
+    operator delete(ptr, align);
+}
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace episteme::alloc {
+#ifdef EPISTEME_ALLOC_COUNT
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    struct Counts {
+        uint64_t allocations = 0;
+        uint64_t deallocations = 0;
+        uint64_t bytes = 0;
+
+        inline Counts operator-(const Counts& other) const {
+            return {
+                .allocations = allocations - other.allocations,
+                .deallocations = deallocations - other.deallocations,
+                .bytes = bytes - other.bytes
+            };
+        }
+
+        inline Counts& operator+=(const Counts& other) {
+            allocations += other.allocations;
+            deallocations += other.deallocations;
+            bytes += other.bytes;
+            return *this;
+        }
+    };
+
+    // Heap activity of the calling thread; always zero unless built with EPISTEME_ALLOC_COUNT
+    Counts thread_counts();
+}
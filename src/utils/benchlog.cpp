@@ -0,0 +1,198 @@
+#include "benchlog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+namespace episteme::benchlog {
+    namespace {
+        // Raw text of a top-level value; history lines are written by append, so no general parser is needed
+        std::string field(const std::string& line, const std::string& key) {
+            const std::string pattern = "\"" + key + "\":";
+            size_t start = line.find(pattern);
+            if (start == std::string::npos) return "";
+            start += pattern.size();
+
+            if (line[start] == '"') {
+                size_t end = line.find('"', start + 1);
+                return line.substr(start + 1, end - start - 1);
+            }
+
+            const char close = (line[start] == '[') ? ']' : (line[start] == '{') ? '}' : '\0';
+            size_t end = close ? line.find(close, start) + 1 : line.find_first_of(",}", start);
+            return line.substr(start, end - start);
+        }
+
+        std::string escape(const std::string& text) {
+            std::string out;
+            for (char c : text) {
+                if (c == '"' || c == '\\') out += '\\';
+                out += c;
+            }
+            return out;
+        }
+
+        // Regularized incomplete beta function I_x(a, b) by continued fraction (Lentz's method)
+        double incomplete_beta(double a, double b, double x) {
+            if (x <= 0) return 0;
+            if (x >= 1) return 1;
+            if (x > (a + 1) / (a + b + 2)) return 1 - incomplete_beta(b, a, 1 - x);
+
+            constexpr double TINY = 1e-300;
+            const double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log(1 - x)) / a;
+
+            double c = 1, d = 1 - (a + b) * x / (a + 1);
+            d = 1 / (std::abs(d) < TINY ? TINY : d);
+            double result = d;
+
+            for (int m = 1; m <= 200; m++) {
+                for (int step = 0; step < 2; step++) {
+                    const double numerator = step == 0
+                        ? m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m))
+                        : -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+
+                    d = 1 + numerator * d;
+                    d = 1 / (std::abs(d) < TINY ? TINY : d);
+                    c = 1 + numerator / c;
+                    if (std::abs(c) < TINY) c = TINY;
+                    result *= c * d;
+                }
+
+                if (std::abs(c * d - 1) < 1e-12) break;
+            }
+
+            return front * result;
+        }
+
+        double mean(const std::vector<double>& values) {
+            return std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+        }
+
+        double variance(const std::vector<double>& values, double avg) {
+            double sum = 0;
+            for (double value : values) sum += (value - avg) * (value - avg);
+            return sum / (values.size() - 1);
+        }
+    }
+
+    std::string hardware_fingerprint() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line, model = "unknown";
+
+        while (std::getline(cpuinfo, line)) {
+            if (line.starts_with("model name")) {
+                model = line.substr(line.find(':') + 2);
+                break;
+            }
+        }
+
+        return model + " x" + std::to_string(std::thread::hardware_concurrency());
+    }
+
+    bool append(const std::string& path, const Entry& entry) {
+        std::ofstream file(path, std::ios::app);
+        if (!file) return false;
+
+        file << "{\"timestamp\":" << entry.timestamp
+            << ",\"commit\":\"" << escape(entry.commit) << "\""
+            << ",\"hardware\":\"" << escape(entry.hardware) << "\""
+            << ",\"depth\":" << entry.depth
+            << ",\"threads\":" << entry.num_threads
+            << ",\"hash\":" << entry.hash_size
+            << ",\"nodes\":" << entry.nodes
+            << ",\"nps\":[";
+        for (size_t i = 0; i < entry.nps.size(); i++) {
+            file << (i ? "," : "") << static_cast<uint64_t>(entry.nps[i]);
+        }
+        file << "],\"perf\":";
+        perf::print_json(file, entry.perf, entry.perf_nodes);
+        file << "}\n";
+
+        return static_cast<bool>(file);
+    }
+
+    std::vector<Entry> load(const std::string& path) {
+        std::vector<Entry> entries;
+        std::ifstream file(path);
+        std::string line;
+
+        while (std::getline(file, line)) {
+            if (line.empty()) continue;
+
+            Entry entry;
+            entry.commit = field(line, "commit");
+            entry.hardware = field(line, "hardware");
+
+            try {
+                entry.timestamp = std::stoll(field(line, "timestamp"));
+                entry.depth = std::stoi(field(line, "depth"));
+                entry.num_threads = std::stoi(field(line, "threads"));
+                entry.hash_size = std::stoi(field(line, "hash"));
+                entry.nodes = std::stoull(field(line, "nodes"));
+            } catch (const std::exception&) {
+                continue;
+            }
+
+            std::string nps = field(line, "nps");
+            std::replace(nps.begin(), nps.end(), ',', ' ');
+            std::istringstream iss(nps.substr(1, nps.size() - 2));
+            double value;
+            while (iss >> value) entry.nps.push_back(value);
+
+            entries.push_back(std::move(entry));
+        }
+
+        return entries;
+    }
+
+    Comparison compare(const std::vector<double>& baseline, const std::vector<double>& current) {
+        Comparison comparison;
+        if (baseline.empty() || current.empty()) return comparison;
+
+        comparison.baseline_mean = mean(baseline);
+        comparison.current_mean = mean(current);
+        comparison.change = comparison.baseline_mean > 0 ? (comparison.current_mean - comparison.baseline_mean) / comparison.baseline_mean : 0;
+
+        if (baseline.size() < 2 || current.size() < 2) return comparison;
+        comparison.tested = true;
+
+        const double var_a = variance(baseline, comparison.baseline_mean) / baseline.size();
+        const double var_b = variance(current, comparison.current_mean) / current.size();
+        if (var_a + var_b <= 0) {
+            comparison.p = (comparison.baseline_mean == comparison.current_mean) ? 1 : 0;
+            return comparison;
+        }
+
+        comparison.t = (comparison.current_mean - comparison.baseline_mean) / std::sqrt(var_a + var_b);
+        comparison.df = (var_a + var_b) * (var_a + var_b)
+            / (var_a * var_a / (baseline.size() - 1) + var_b * var_b / (current.size() - 1));
+        comparison.p = incomplete_beta(comparison.df / 2, 0.5, comparison.df / (comparison.df + comparison.t * comparison.t));
+
+        return comparison;
+    }
+
+    void print_comparison(const Comparison& comparison, const char* baseline_name, const char* current_name) {
+        constexpr double ALPHA = 0.05;
+
+        std::cout << std::fixed << std::setprecision(2)
+            << "info compare " << baseline_name << " " << static_cast<uint64_t>(comparison.baseline_mean)
+            << " " << current_name << " " << static_cast<uint64_t>(comparison.current_mean)
+            << " change " << std::showpos << 100 * comparison.change << std::noshowpos << "%";
+
+        // A single sample on either side has no variance to test against, so there is no verdict to give
+        if (!comparison.tested) {
+            std::cout << " insufficient samples for a significance test";
+        } else {
+            std::cout << " t " << comparison.t << " df " << comparison.df << std::setprecision(4) << " p " << comparison.p << " ";
+            if (comparison.p >= ALPHA) std::cout << "no significant change";
+            else std::cout << (comparison.change > 0 ? "faster" : "slower");
+        }
+
+        std::cout << std::endl << std::defaultfloat << std::setprecision(6);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "perf.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace episteme::benchlog {
+    // One bench invocation as stored in the history file, one JSON object per line
+    struct Entry {
+        int64_t timestamp = 0;
+        std::string commit;
+        std::string hardware;
+        int depth = 0;
+        uint16_t num_threads = 1;
+        uint32_t hash_size = 0;
+        uint64_t nodes = 0;
+        std::vector<double> nps;
+        perf::Sample perf;
+        double perf_nodes = 0;
+    };
+
+    struct Comparison {
+        double baseline_mean = 0;
+        double current_mean = 0;
+        double change = 0;
+        double t = 0;
+        double df = 0;
+        double p = 1;
+        bool tested = false;
+    };
+
+    // CPU model and logical core count, enough to avoid comparing runs across machines
+    [[nodiscard]] std::string hardware_fingerprint();
+
+    bool append(const std::string& path, const Entry& entry);
+    [[nodiscard]] std::vector<Entry> load(const std::string& path);
+
+    // Welch's t-test, as nps samples from different builds need not share a variance
+    [[nodiscard]] Comparison compare(const std::vector<double>& baseline, const std::vector<double>& current);
+    void print_comparison(const Comparison& comparison, const char* baseline_name, const char* current_name);
+}
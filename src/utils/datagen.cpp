@@ -1,10 +1,94 @@
 #include "datagen.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <cassert>
+#include <cerrno>
+#include <cstring>
 
 namespace episteme::datagen {
     using namespace std::chrono;
 
+    Writer::~Writer() {
+        finish();
+    }
+
+    bool Writer::open(const std::filesystem::path& path) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+
+        batch.reserve(BATCH_SIZE);
+        thread = std::thread(&Writer::loop, this);
+        return true;
+    }
+
+    void Writer::submit(std::vector<char>&& game) {
+        while (!failed() && !queue.try_push(game)) std::this_thread::yield();
+    }
+
+    void Writer::finish() {
+        if (!thread.joinable()) return;
+
+        done = true;
+        thread.join();
+
+        ::close(fd);
+        fd = -1;
+    }
+
+    // Batches only ever hold whole games, so the file is valid data at every flush
+    bool Writer::flush() {
+        size_t offset = 0;
+        while (offset < batch.size()) {
+            ssize_t result = ::write(fd, batch.data() + offset, batch.size() - offset);
+            if (result < 0) {
+                if (errno == EINTR) continue;
+
+                // Whatever did reach the file must not be written a second time
+                written += offset;
+                batch.erase(batch.begin(), batch.begin() + offset);
+                return false;
+            }
+            offset += result;
+        }
+
+        written += batch.size();
+        batch.clear();
+        return fdatasync(fd) == 0;
+    }
+
+    void Writer::loop() {
+        constexpr auto FLUSH_INTERVAL = seconds(1);
+
+        std::vector<char> game;
+        time_point last_flush = steady_clock::now();
+
+        while (true) {
+            const bool finishing = done.load();
+            const bool popped = queue.try_pop(game);
+
+            // Once a write has failed, queued games are only drained so submitters never block
+            if (popped && !failed()) batch.insert(batch.end(), game.begin(), game.end());
+            game.clear();
+
+            const bool drained = finishing && !popped;
+            const bool due = !batch.empty() && (batch.size() >= BATCH_SIZE || drained || (!popped && steady_clock::now() - last_flush >= FLUSH_INTERVAL));
+
+            if (due) {
+                if (!flush()) {
+                    std::cout << "Error writing datagen output: " << std::strerror(errno) << std::endl;
+                    write_failed = true;
+                    batch.clear();
+                }
+                last_flush = steady_clock::now();
+            }
+
+            if (drained) break;
+            if (!popped) std::this_thread::sleep_for(milliseconds(1));
+        }
+    }
+
     void play_random(Position& position, int32_t num_moves) {
         for (int i = 0; i < num_moves; i++) {
             MoveList move_list;
@@ -27,9 +111,8 @@ namespace episteme::datagen {
         }
     }
 
-    void game_loop(const Parameters& params, std::ostream& stream, uint32_t id) {
+    void game_loop(const Parameters& params, Writer& writer, Progress& progress) {
         Position position;
-        position.from_startpos();
 
         Format formatter{};
 
@@ -45,22 +128,20 @@ namespace episteme::datagen {
         };
 
         search::Engine engine(cfg);
-        time_point start = steady_clock::now();
-        size_t positions = 0;
-        size_t games = 0;
-        
-        int workload = params.num_games / params.num_threads;
-        for (int i = 0; i < workload && !stop; i++) {
-            engine.reset_game();
-            play_random(position, 8);
-            formatter.init(position);
-
-            search::ScoredMove initial = engine.datagen_search(position);
-            if (initial.score >= INITIAL_MAX) {
-                i--;
+
+        // Games are claimed one at a time, so threads that draw short games simply take more of them
+        while (!stop && !writer.failed() && progress.claimed.fetch_add(1, std::memory_order_relaxed) < params.num_games) {
+            search::ScoredMove initial;
+            do {
                 position.from_startpos();
-                continue;
-            };
+                engine.reset_game();
+                play_random(position, 8);
+                formatter.init(position);
+
+                initial = engine.datagen_search(position);
+            } while (initial.score >= INITIAL_MAX && !stop);
+
+            if (stop) break;
 
             uint64_t win_plies = 0, draw_plies = 0, loss_plies = 0;
             std::optional<uint8_t> wdl{};
@@ -98,23 +179,20 @@ namespace episteme::datagen {
                 engine.reset_go();
             }
 
-            games++;
-            positions += formatter.write(stream, static_cast<uint8_t>(*wdl));
+            if (!wdl) break;
 
-            position.from_startpos();
+            std::vector<char> buffer;
+            const size_t positions = formatter.write(buffer, static_cast<uint8_t>(*wdl));
+            writer.submit(std::move(buffer));
 
-            if ((i + 1) % 16 == 0 || (i + 1) == workload) {
-                time_point end = steady_clock::now();
-                int32_t elapsed = duration_cast<milliseconds>(end - start).count() / 1000;
-                std::cout << "Thread " << id << ": " << games << "/" << workload << " games completed at " << positions / (elapsed > 0 ? elapsed : 1) << " pos/sec" << std::endl;
+            const uint64_t total_positions = progress.positions.fetch_add(positions, std::memory_order_relaxed) + positions;
+            const int32_t games = progress.games.fetch_add(1, std::memory_order_relaxed) + 1;
 
-                start = steady_clock::now();
-                positions = 0;
-            }
+            if (games % 16 == 0) progress.report(games, total_positions, params.num_games);
         }
     }
 
-    void run(Parameters& params) {
+    bool run(Parameters& params) {
         std::cout << "Beginning datagen." << std::endl;
 
         std::signal(SIGINT, []([[maybe_unused]] int signum){
@@ -123,65 +201,39 @@ namespace episteme::datagen {
             return;
         });
 
-        params.num_games = params.num_threads * (params.num_games / params.num_threads);
-
-        std::vector<std::thread> threads;
-        std::vector<std::string> files;
-
         std::filesystem::create_directory(std::filesystem::path(params.out_dir));
 
-        for (size_t i = 0; i < params.num_threads; i++) {
+        std::ostringstream oss;
+        oss << params.out_dir << "/data." << Format::EXTENSION;
+        const auto output = std::filesystem::path(oss.str());
 
-            std::ostringstream oss;
-            oss << params.out_dir << "/temp_" << i << "." << Format::EXTENSION;
-            const auto file = std::filesystem::path(oss.str());
-            files.push_back(file);
-
-            threads.emplace_back(
-                [&params, file = std::move(file), i]() {
-                    std::ofstream stream(file, std::ios::binary | std::ios::app);
-                    if (!stream) {
-                        std::cout << "Failed to open " << file.string() << " on thread " << i << std::endl;
-                        return;
-                    }
+        Writer writer;
+        if (!writer.open(output)) {
+            std::cout << "Failed to open output file " << output.string() << std::endl;
+            return false;
+        }
 
-                    game_loop(params, stream, i);
+        Progress progress;
 
-                    if (!stream.good()) {
-                        std::cout << "Error encountered on thread " << i << " when closing" << std::endl;
-                    }
-                }
-            );
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < params.num_threads; i++) {
+            threads.emplace_back([&params, &writer, &progress]() {
+                game_loop(params, writer, progress);
+            });
         }
 
         for (auto& thread : threads) thread.join();
+        writer.finish();
 
-        std::cout << "Generated " << params.num_threads << " data files. Concatenating." << std::endl;
+        progress.report(progress.games.load(), progress.positions.load(), params.num_games);
+        std::cout << "Wrote " << writer.bytes_written() << " bytes to " << output.string() << std::endl;
 
-        std::ostringstream oss;
-        oss << params.out_dir << "/data." << Format::EXTENSION;
-        const auto output = std::filesystem::path(oss.str());
-
-        std::ofstream final(output, std::ios::binary);
-        if (!final) {
-            std::cout << "Failed to open output file " << output.string() << std::endl;
-        }
-
-        int32_t concats = 0;
-        for (const auto& file : files) {
-            std::ifstream input(file, std::ios::binary);
-            if (input) {
-                final << input.rdbuf();
-                input.close();
-
-                if (std::remove(file.c_str()) == 0) concats++;
-                else std::cout << "Error removing file " << file << " after concatenation" << std::endl;
-            } else {
-                std::cout << "Error opening file " << file << " during concatenation" << std::endl;
-            }
+        if (writer.failed()) {
+            std::cout << "Datagen stopped after a write error." << std::endl;
+            return false;
         }
 
-        std::cout << "Concatenated " << concats << " files" << std::endl;
         std::cout << "Datagen complete." << std::endl;
+        return true;
     }
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "../engine/chess/movegen.h"
 #include "../engine/search/search.h"
 #include "format.h"
+#include "queue.h"
 
 #include <iostream>
 #include <random>
@@ -35,7 +36,58 @@ namespace episteme::datagen {
         std::string out_dir = "data";
     };
 
+    // Game threads hand over finished games; a single thread batches them into one output file
+    class Writer {
+        public:
+            static constexpr size_t QUEUE_SIZE = 1024;
+            static constexpr size_t BATCH_SIZE = 4 * 1024 * 1024;
+
+            Writer() = default;
+            Writer(const Writer&) = delete;
+            Writer& operator=(const Writer&) = delete;
+            ~Writer();
+
+            bool open(const std::filesystem::path& path);
+            void submit(std::vector<char>&& game);
+            void finish();
+
+            [[nodiscard]] inline uint64_t bytes_written() const {
+                return written;
+            }
+
+            // After the first failed write the file is left as it is and further games are dropped
+            [[nodiscard]] inline bool failed() const {
+                return write_failed.load(std::memory_order_relaxed);
+            }
+
+        private:
+            void loop();
+            bool flush();
+
+            BoundedQueue<std::vector<char>, QUEUE_SIZE> queue;
+            std::vector<char> batch;
+            std::thread thread;
+            std::atomic<bool> done = false;
+            std::atomic<bool> write_failed = false;
+            int fd = -1;
+            uint64_t written = 0;
+    };
+
+    // Shared by all game threads: the next game to claim and running totals for throughput
+    struct Progress {
+        std::atomic<int32_t> claimed = 0;
+        std::atomic<int32_t> games = 0;
+        std::atomic<uint64_t> positions = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        void report(int32_t completed, uint64_t total_positions, int32_t target) const {
+            const int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+            std::cout << completed << "/" << target << " games, " << total_positions << " positions at "
+                << (elapsed > 0 ? 1000 * total_positions / elapsed : total_positions) << " pos/sec" << std::endl;
+        }
+    };
+
     void play_random(Position& position, int32_t num_moves);
-    void game_loop(const Parameters& params, std::ostream& stream, uint32_t id);
-    void run(Parameters& params);
+    void game_loop(const Parameters& params, Writer& writer, Progress& progress);
+    [[nodiscard]] bool run(Parameters& params);
 }
\ No newline at end of file
@@ -25,14 +25,17 @@ namespace episteme::datagen {
         moves.push_back({viri_move, static_cast<int16_t>(score)});
     }
 
-    size_t Format::write(std::ostream& stream, uint8_t wdl) {
-        static constexpr std::array<uint8_t, sizeof(ScoredMove)> NULL_TERMINATOR{};
+    size_t Format::write(std::vector<char>& buffer, uint8_t wdl) {
+        static constexpr std::array<char, sizeof(ScoredMove)> NULL_TERMINATOR{};
 
         initial.wdl = wdl;
 
-        stream.write(reinterpret_cast<const char*>(&initial), sizeof(PackedBoard));
-        stream.write(reinterpret_cast<const char*>(moves.data()), sizeof(ScoredMove) * moves.size());
-        stream.write(reinterpret_cast<const char*>(NULL_TERMINATOR.data()), sizeof(ScoredMove));
+        const char* board = reinterpret_cast<const char*>(&initial);
+        const char* scored_moves = reinterpret_cast<const char*>(moves.data());
+
+        buffer.insert(buffer.end(), board, board + sizeof(PackedBoard));
+        buffer.insert(buffer.end(), scored_moves, scored_moves + sizeof(ScoredMove) * moves.size());
+        buffer.insert(buffer.end(), NULL_TERMINATOR.begin(), NULL_TERMINATOR.end());
 
         return moves.size() + 1;
     }
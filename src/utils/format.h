@@ -94,7 +94,7 @@ namespace episteme::datagen {
 
             void init(const Position& position);
             void push(Move move, int32_t score);
-            size_t write(std::ostream& stream, uint8_t wdl);
+            size_t write(std::vector<char>& buffer, uint8_t wdl);
         private:
             PackedBoard initial{};
             std::vector<ScoredMove> moves;
@@ -0,0 +1,69 @@
+#include "memory.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <iostream>
+
+namespace episteme::memory {
+    size_t resident_bytes(const void* data, size_t bytes) {
+        if (!data || !bytes) return 0;
+
+        const uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(data);
+        const uintptr_t end = begin + bytes;
+        const uintptr_t first_page = begin & ~(page_size - 1);
+        const size_t num_pages = (end - first_page + page_size - 1) / page_size;
+
+        std::vector<unsigned char> pages(num_pages);
+        if (mincore(reinterpret_cast<void*>(first_page), end - first_page, pages.data()) != 0) return 0;
+
+        size_t resident = 0;
+        for (size_t i = 0; i < num_pages; i++) {
+            if (!(pages[i] & 1)) continue;
+
+            // Edge pages only count the part that overlaps the region
+            const uintptr_t page_begin = std::max(first_page + i * page_size, begin);
+            const uintptr_t page_end = std::min(first_page + (i + 1) * page_size, end);
+            resident += page_end - page_begin;
+        }
+
+        return resident;
+    }
+
+    void report(const std::vector<Region>& regions, uint16_t num_threads, uint32_t hash_size, size_t hash_bytes) {
+        constexpr std::array<const char*, 4> SCOPE_NAMES = {"shared", "thread", "hash", "unused"};
+
+        size_t total = 0;
+        size_t total_resident = 0;
+        size_t shared = 0;
+        size_t per_thread = 0;
+        size_t unused = 0;
+
+        std::cout << std::fixed << std::setprecision(1);
+        for (const Region& region : regions) {
+            const size_t resident = resident_bytes(region.data, region.bytes);
+
+            total += region.bytes;
+            total_resident += resident;
+            if (region.scope == Scope::Shared) shared += region.bytes;
+            else if (region.scope == Scope::PerThread) per_thread += region.bytes;
+            else if (region.scope == Scope::Unused) unused += region.bytes;
+
+            std::cout << "memory " << std::left << std::setw(20) << region.name << std::setw(8) << SCOPE_NAMES[static_cast<size_t>(region.scope)] << std::right
+                << std::setw(14) << region.bytes << " bytes"
+                << std::setw(14) << resident << " resident"
+                << std::setw(8) << (region.bytes ? 100.0 * resident / region.bytes : 0.0) << "%\n";
+        }
+
+        std::cout << "memory total " << total << " bytes, " << total_resident << " resident\n";
+        std::cout << "memory projected threads " << num_threads << " hash " << hash_size << " mb: "
+            << shared + num_threads * per_thread + hash_bytes << " bytes ("
+            << shared << " shared + " << num_threads << " x " << per_thread << " per thread + " << hash_bytes << " hash)\n";
+        if (unused) std::cout << "memory unused " << unused << " bytes mapped but not touched by this build\n";
+        std::cout << std::defaultfloat << std::setprecision(6) << std::flush;
+    }
+}
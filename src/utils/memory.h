@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace episteme::memory {
+    enum class Scope : uint8_t {
+        Shared, PerThread, Hash, Unused
+    };
+
+    struct Region {
+        std::string name;
+        const void* data;
+        size_t bytes;
+        Scope scope;
+    };
+
+    // Bytes of [data, data + bytes) backed by resident pages, per mincore
+    [[nodiscard]] size_t resident_bytes(const void* data, size_t bytes);
+
+    // The projection swaps the live table for one of hash_bytes and scales per-thread regions by num_threads;
+    // unused regions are mapped but never touched, so they are listed and left out of it
+    void report(const std::vector<Region>& regions, uint16_t num_threads, uint32_t hash_size, size_t hash_bytes);
+}
@@ -0,0 +1,173 @@
+#include "perf.h"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace episteme::perf {
+    namespace {
+        constexpr uint64_t cache_event(uint64_t cache, uint64_t op, uint64_t result) {
+            return cache | (op << 8) | (result << 16);
+        }
+
+        constexpr std::array<std::pair<uint32_t, uint64_t>, NUM_EVENTS> EVENT_CONFIGS = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)}
+        }};
+
+        struct ReadFormat {
+            uint64_t nr;
+            uint64_t time_enabled;
+            uint64_t time_running;
+            std::array<uint64_t, NUM_EVENTS> values;
+        };
+    }
+
+    void Counters::open_group(std::initializer_list<Event> events) {
+        Group& group = groups[num_groups];
+
+        // The first event that opens leads; the kernel rejects members that can't be scheduled alongside it
+        for (Event event : events) {
+            const size_t i = static_cast<size_t>(event);
+
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+
+            attr.size = sizeof(attr);
+            attr.type = EVENT_CONFIGS[i].first;
+            attr.config = EVENT_CONFIGS[i].second;
+            attr.disabled = (group.leader < 0);
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group.leader, 0));
+            if (fds[i] < 0) continue;
+
+            if (group.leader < 0) group.leader = fds[i];
+            group.order[group.size++] = i;
+        }
+
+        if (group.leader >= 0) num_groups++;
+    }
+
+    void Counters::close_all() {
+        // Members go before the leader they belong to
+        for (size_t g = 0; g < num_groups; g++) {
+            for (size_t i = groups[g].size; i-- > 0;) close(fds[groups[g].order[i]]);
+            groups[g] = Group{};
+        }
+
+        fds.fill(-1);
+        num_groups = 0;
+    }
+
+    Counters::Counters() {
+        fds.fill(-1);
+        open_group({Event::Cycles, Event::Instructions, Event::L1DMisses, Event::LLCMisses, Event::BranchMisses, Event::DTLBMisses});
+        if (!num_groups) return;
+
+        // A group that opens can still be impossible to schedule, in which case it never runs; probe it once
+        start();
+        for (int i = 0; i < 100000; i++) asm volatile("");
+        if (stop().any()) return;
+
+        close_all();
+        split = true;
+        open_group({Event::Cycles, Event::Instructions});
+        open_group({Event::L1DMisses, Event::LLCMisses, Event::DTLBMisses});
+        open_group({Event::BranchMisses});
+    }
+
+    Counters::~Counters() {
+        close_all();
+    }
+
+    bool Counters::available() const {
+        return num_groups > 0;
+    }
+
+    void Counters::start() {
+        for (size_t g = 0; g < num_groups; g++) {
+            ioctl(groups[g].leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(groups[g].leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    Sample Counters::stop() {
+        Sample sample;
+        sample.split = split;
+
+        for (size_t g = 0; g < num_groups; g++) ioctl(groups[g].leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        for (size_t g = 0; g < num_groups; g++) {
+            const Group& group = groups[g];
+
+            ReadFormat data;
+            const ssize_t expected = static_cast<ssize_t>(3 * sizeof(uint64_t) + group.size * sizeof(uint64_t));
+            if (read(group.leader, &data, sizeof(data)) != expected || data.nr != group.size || data.time_running == 0) continue;
+
+            // A group is multiplexed as a unit, so one scale applies to all its events and leaves their ratios intact
+            double scale = static_cast<double>(data.time_enabled) / data.time_running;
+            sample.scaled |= data.time_running < data.time_enabled;
+            for (size_t i = 0; i < group.size; i++) {
+                sample.values[group.order[i]] = static_cast<uint64_t>(data.values[i] * scale);
+                sample.valid[group.order[i]] = true;
+            }
+        }
+
+        return sample;
+    }
+
+    void print_rates(std::ostream& out, const Sample& sample, double ops, const char* unit) {
+        if (!sample.any()) {
+            out << " perf unavailable";
+            return;
+        }
+
+        for (size_t i = 0; i < NUM_EVENTS; i++) {
+            if (sample.valid[i]) out << " " << EVENT_NAMES[i] << " " << sample.values[i] / ops << "/" << unit;
+        }
+
+        if (sample.has(Event::Cycles) && sample.has(Event::Instructions) && sample[Event::Cycles]) {
+            out << " ipc " << static_cast<double>(sample[Event::Instructions]) / sample[Event::Cycles];
+        }
+
+        bool dropped = false;
+        for (size_t i = 0; i < NUM_EVENTS; i++) {
+            if (sample.valid[i]) continue;
+            out << (dropped ? "," : " (dropped ") << EVENT_NAMES[i];
+            dropped = true;
+        }
+        if (dropped) out << ")";
+
+        if (sample.scaled) out << " (warning: counts scaled for multiplexing)";
+        if (sample.split) out << " (warning: counted in separate groups, cross-group ratios approximate)";
+    }
+
+    void print_json(std::ostream& out, const Sample& sample, double ops) {
+        out << "{";
+
+        bool first = true;
+        for (size_t i = 0; i < NUM_EVENTS; i++) {
+            if (!sample.valid[i]) continue;
+
+            out << (first ? "" : ",") << "\"" << EVENT_NAMES[i] << "\":" << sample.values[i]
+                << ",\"" << EVENT_NAMES[i] << "_per_op\":" << sample.values[i] / ops;
+            first = false;
+        }
+
+        if (sample.any()) {
+            out << (first ? "" : ",") << "\"scaled\":" << (sample.scaled ? "true" : "false") << ",\"split\":" << (sample.split ? "true" : "false");
+        }
+
+        out << "}";
+    }
+}
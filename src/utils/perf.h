@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <initializer_list>
+#include <ostream>
+
+namespace episteme::perf {
+    enum class Event : uint8_t {
+        Cycles, Instructions, L1DMisses, LLCMisses, BranchMisses, DTLBMisses
+    };
+
+    constexpr size_t NUM_EVENTS = 6;
+    constexpr std::array<const char*, NUM_EVENTS> EVENT_NAMES = {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"
+    };
+
+    struct Sample {
+        std::array<uint64_t, NUM_EVENTS> values{};
+        std::array<bool, NUM_EVENTS> valid{};
+
+        // Set when the kernel multiplexed counters and the values were scaled up from part of the run
+        bool scaled = false;
+        // Set when the events had to be counted in several groups, so ratios across groups are approximate
+        bool split = false;
+
+        [[nodiscard]] inline bool has(Event event) const {
+            return valid[static_cast<size_t>(event)];
+        }
+
+        [[nodiscard]] inline uint64_t operator[](Event event) const {
+            return values[static_cast<size_t>(event)];
+        }
+
+        [[nodiscard]] inline bool any() const {
+            for (bool v : valid) if (v) return true;
+            return false;
+        }
+
+        // An empty sample takes on the events of the first one added to it
+        inline Sample& operator+=(const Sample& other) {
+            const bool empty = !any();
+            for (size_t i = 0; i < NUM_EVENTS; i++) {
+                valid[i] = (empty || valid[i]) && other.valid[i];
+                values[i] += other.values[i];
+            }
+            scaled |= other.scaled;
+            split |= other.split;
+            return *this;
+        }
+    };
+
+    // Counts user-space events of the calling thread as one group led by cycles, so every event is
+    // scheduled over the same window and ratios between them are exact. When the PMU can't fit the
+    // whole group it falls back to smaller groups of related events; events the kernel refuses are left out
+    class Counters {
+        public:
+            Counters();
+            Counters(const Counters&) = delete;
+            Counters& operator=(const Counters&) = delete;
+            ~Counters();
+
+            [[nodiscard]] bool available() const;
+
+            void start();
+            Sample stop();
+
+        private:
+            struct Group {
+                int leader = -1;
+
+                // Events in the order the kernel reports them in a group read
+                std::array<size_t, NUM_EVENTS> order{};
+                size_t size = 0;
+            };
+
+            void open_group(std::initializer_list<Event> events);
+            void close_all();
+
+            std::array<int, NUM_EVENTS> fds;
+            std::array<Group, NUM_EVENTS> groups{};
+            size_t num_groups = 0;
+            bool split = false;
+    };
+
+    void print_rates(std::ostream& out, const Sample& sample, double ops, const char* unit);
+    void print_json(std::ostream& out, const Sample& sample, double ops);
+}
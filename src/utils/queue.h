@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace episteme {
+    // Bounded lock-free queue after Vyukov: each slot's sequence number says whose turn it is to use it
+    template<typename T, size_t CAPACITY>
+    class BoundedQueue {
+        static_assert(std::has_single_bit(CAPACITY), "capacity must be a power of two");
+
+        public:
+            BoundedQueue() : slots(std::make_unique<Slot[]>(CAPACITY)) {
+                for (size_t i = 0; i < CAPACITY; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            // Leaves value untouched and returns false when the queue is full
+            bool try_push(T& value) {
+                size_t pos = tail.load(std::memory_order_relaxed);
+
+                while (true) {
+                    Slot& slot = slots[pos & (CAPACITY - 1)];
+                    const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                    const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+                    if (diff == 0) {
+                        if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            slot.value = std::move(value);
+                            slot.sequence.store(pos + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0) return false;
+                    else pos = tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            bool try_pop(T& out) {
+                size_t pos = head.load(std::memory_order_relaxed);
+
+                while (true) {
+                    Slot& slot = slots[pos & (CAPACITY - 1)];
+                    const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                    const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+                    if (diff == 0) {
+                        if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            out = std::move(slot.value);
+                            slot.sequence.store(pos + CAPACITY, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0) return false;
+                    else pos = head.load(std::memory_order_relaxed);
+                }
+            }
+
+        private:
+            struct Slot {
+                std::atomic<size_t> sequence;
+                T value;
+            };
+
+            std::unique_ptr<Slot[]> slots;
+            alignas(64) std::atomic<size_t> head = 0;
+            alignas(64) std::atomic<size_t> tail = 0;
+    };
+}